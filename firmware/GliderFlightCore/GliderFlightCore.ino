@@ -3,6 +3,11 @@
 #include "src/core/Sensors.h"
 #include "src/core/Network.h"
 #include "src/core/FlightManager.h"
+#include "src/core/Scheduler.h"
+#include "src/actuators/ServoExecutor.h"
+#ifdef KERNEL_BENCH
+#include "src/diagnostics/KernelBench.h"
+#endif
 
 // Определение глобального объекта пинов
 Config::PinConfig pins;
@@ -18,22 +23,33 @@ void setup()
     // 1. Сначала ФС и загрузка пинов
     Storage::begin();
     Storage::loadPins(pins);
+    Logging::recorder.begin(); // Восстановление лога, прерванного сбросом питания
+    Diagnostics::launchLatency.begin();
 
     // 2. Инициализация базовой периферии
     pinMode(pins.led, OUTPUT);
     digitalWrite(pins.led, HIGH);
+    Actuators::servo.begin(pins.servo); // Стоп-импульсы с первых секунд: сервопривод не дергается
 
     // 3. Инициализация подсистем (теперь они видят загруженные пины)
     Sensors::begin();
     Flight::setup();
     Network::setup();
 
+    // 4. Задачи loop(): датчики и полет раньше сети, в полете сеть не обслуживается
+    Scheduler::add("sensors", Sensors::update, TASK_SENSORS_PERIOD_US, 0, SENSOR_LOOP_BUDGET_US);
+    Scheduler::add("flight", Flight::update, TASK_FLIGHT_PERIOD_US, 1, TASK_FLIGHT_BUDGET_US);
+    Scheduler::add("network", Network::loop, TASK_NETWORK_PERIOD_US, 3, TASK_NETWORK_BUDGET_US,
+                   Scheduler::modeBit(Config::STATE_SETUP) | Scheduler::modeBit(Config::STATE_ARMED));
+
+#ifdef KERNEL_BENCH
+    Diagnostics::runKernelBench();
+#endif
+
     Serial.println("--- System Ready (Idle Mode) ---");
 }
 
 void loop()
 {
-    Network::loop();
-    Sensors::update();
-    Flight::update();
+    Scheduler::run(Sensors::sys.flightState);
 }
\ No newline at end of file
@@ -0,0 +1,58 @@
+#ifndef FLIGHT_PROGRAM_H
+#define FLIGHT_PROGRAM_H
+
+#include <ArduinoJson.h>
+#include "../config/Config.h"
+
+namespace Actuators
+{
+    /**
+     * Шаг программы: вращение сервопривода в направлении direction
+     * (1 — по часовой, -1 — против, 0 — стоп) в течение durationMs
+     */
+    struct ServoStep
+    {
+        int8_t direction;
+        uint32_t durationMs;
+
+        uint16_t pulseUs() const
+        {
+            return direction > 0 ? SERVO_PULSE_CW_US : direction < 0 ? SERVO_PULSE_CCW_US : SERVO_PULSE_STOP_US;
+        }
+    };
+
+    /**
+     * Value Object: полетная программа из program.json (формат /program, WEB API.md).
+     * Шаги идут подряд от момента пуска, после последнего сервопривод стоит.
+     */
+    struct FlightProgram
+    {
+        uint8_t count = 0;
+        ServoStep steps[SERVO_MAX_STEPS];
+
+        bool deserialize(const String &json)
+        {
+            count = 0;
+            if (json == "")
+                return false;
+            DynamicJsonDocument doc(2048);
+            if (deserializeJson(doc, json))
+                return false;
+
+            for (JsonObject step : doc["steps"].as<JsonArray>())
+            {
+                if (count >= SERVO_MAX_STEPS)
+                    break;
+                int direction = step["direction"] | 0;
+                uint32_t sec = step["durationSec"] | 0;
+                uint32_t ms = step["durationMs"] | 0;
+                steps[count].direction = constrain(direction, -1, 1);
+                steps[count].durationMs = sec * 1000 + ms;
+                count++;
+            }
+            return true;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,252 @@
+#ifndef SERVO_EXECUTOR_H
+#define SERVO_EXECUTOR_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <LittleFS.h>
+#include "FlightProgram.h"
+#include "../config/Config.h"
+#include "../core/Storage.h"
+
+namespace Actuators
+{
+    /**
+     * Исполнитель полетной программы на аппаратном таймере.
+     *
+     * PWM сервопривода формирует прерывание timer1 (однократный режим,
+     * перезапуск из обработчика): фронт импульса, спад через pulseUs, пауза до
+     * конца кадра SERVO_FRAME_US. Шаги программы переключаются тем же
+     * прерыванием в начале кадра; если срок шага наступает раньше конца
+     * кадра, пауза укорачивается (но не короче SERVO_MIN_GAP_US), поэтому
+     * новый импульс выходит точно к сроку. Сроки считаются от фронта пуска
+     * по плану, а не от фактического начала предыдущего шага — ошибка не копится.
+     *
+     * Обработчик и все, что он вызывает (micros, digitalWrite, timer1_write
+     * ядра), лежат в IRAM: запись во флеш отключает кэш, и код из флеша в это
+     * время выполняться не может. loop() с его I2C и записью лога на импульсы
+     * не влияет.
+     *
+     * Фактическое время каждого шага (мкс от пуска) сохраняется рядом с
+     * плановым и пишется в /servo_N.json (отдается в /logs/<n>/summary) из
+     * задачи полета, как только программа закончилась: полет часто кончается
+     * снятием питания, а не возвратом в ARMED. Импульсам запись во флеш не
+     * мешает — обработчик в IRAM.
+     */
+    class ServoExecutor
+    {
+    private:
+        static const uint32_t TICKS_PER_US = 5; // TIM_DIV16 при 80 МГц
+        static const uint32_t NOT_REACHED = UINT32_MAX;
+
+        Config::Pin _pin = -1;
+        FlightProgram _program;
+
+        // События: шаги 0..count-1 и остановка (count); заполняются до пуска
+        uint32_t _plannedUs[SERVO_MAX_STEPS + 1];
+        uint16_t _pulse[SERVO_MAX_STEPS + 1];
+        volatile uint32_t _achievedUs[SERVO_MAX_STEPS + 1];
+
+        // Состояние прерывания
+        volatile uint16_t _pulseUs = SERVO_PULSE_STOP_US;
+        volatile bool _high = false;
+        volatile bool _running = false;
+        volatile uint8_t _event = 0;
+        volatile uint32_t _t0Us = 0;
+        volatile uint32_t _frameStartUs = 0;
+        volatile uint32_t _lowStartUs = 0;
+
+        bool _started = false;
+        bool _saved = true;
+        uint32_t _flightId = 0;
+
+        void IRAM_ATTR advance(uint32_t now)
+        {
+            _achievedUs[_event] = now - _t0Us;
+            _pulseUs = _pulse[_event];
+            if (_event++ == _program.count)
+                _running = false;
+        }
+
+        /**
+         * Наибольшая по модулю ошибка выполненных шагов (факт - план), мкс
+         */
+        int32_t maxErrorUs() const
+        {
+            int32_t worst = 0;
+            for (uint8_t i = 0; i < _event; i++)
+            {
+                int32_t error = (int32_t)(_achievedUs[i] - _plannedUs[i]);
+                if (abs(error) > abs(worst))
+                    worst = error;
+            }
+            return worst;
+        }
+
+        void saveReport()
+        {
+            _saved = true;
+            File file = LittleFS.open(String(SERVO_REPORT_PREFIX) + String(_flightId) + ".json", "w");
+            if (!file)
+                return;
+            // Потоком по шагу: программа до SERVO_MAX_STEPS шагов не собирается в RAM целиком
+            file.print("{\"steps\":" + String(_program.count) + ",\"done\":" + String(_event) +
+                       ",\"max_error_us\":" + String(maxErrorUs()) + ",\"timing\":[");
+            for (uint8_t i = 0; i <= _program.count; i++)
+            {
+                String item = i ? ",[" : "[";
+                item += String(_plannedUs[i]) + ",";
+                item += _achievedUs[i] == NOT_REACHED ? String("null") : String(_achievedUs[i]);
+                file.print(item + "]");
+            }
+            file.print("]}");
+            file.close();
+            Serial.printf("[Servo] Отчет полета %u: шагов %u из %u, наибольшая ошибка %d мкс\n",
+                          _flightId, _event, _program.count + 1, maxErrorUs());
+        }
+
+    public:
+        /**
+         * Обработчик timer1: чередует импульс и паузу, в начале кадра переключает шаг
+         */
+        void IRAM_ATTR onTimer()
+        {
+            uint32_t now = micros();
+            if (_high)
+            {
+                digitalWrite(_pin, LOW);
+                _high = false;
+                _lowStartUs = now;
+                // Без min/max: шаблоны из флеша в обработчике недопустимы
+                int32_t wait = (int32_t)(SERVO_FRAME_US - (now - _frameStartUs));
+                // После остановки _event == count + 1: плановых сроков за массивом нет
+                if (_running)
+                {
+                    int32_t toStep = (int32_t)(_t0Us + _plannedUs[_event] - now);
+                    if (toStep < wait)
+                        wait = toStep;
+                }
+                if (wait < (int32_t)SERVO_MIN_GAP_US)
+                    wait = SERVO_MIN_GAP_US;
+                timer1_write(wait * TICKS_PER_US);
+                return;
+            }
+            if (_running && (int32_t)(now - (_t0Us + _plannedUs[_event])) >= 0)
+                advance(now);
+            digitalWrite(_pin, HIGH);
+            _high = true;
+            _frameStartUs = now;
+            timer1_write(_pulseUs * TICKS_PER_US);
+        }
+
+        /**
+         * Запуск PWM со стоповым импульсом. Вызывается в setup() после загрузки пинов.
+         */
+        void begin(Config::Pin pin);
+
+        /**
+         * Чтение program.json и расчет плановых сроков; вызывается на земле (вход в ARMED)
+         */
+        uint8_t load()
+        {
+            _program.deserialize(Storage::loadProgram());
+            uint32_t at = 0;
+            for (uint8_t i = 0; i < _program.count; i++)
+            {
+                _plannedUs[i] = at;
+                _pulse[i] = _program.steps[i].pulseUs();
+                at += _program.steps[i].durationMs * 1000;
+            }
+            _plannedUs[_program.count] = at;
+            _pulse[_program.count] = SERVO_PULSE_STOP_US;
+            Serial.printf("[Servo] Программа: %u шагов, %u мс\n", _program.count, at / 1000);
+            return _program.count;
+        }
+
+        /**
+         * Пуск программы от фронта t0Us (micros() из прерывания датчика Холла)
+         */
+        void start(uint32_t t0Us)
+        {
+            for (uint8_t i = 0; i <= _program.count; i++)
+                _achievedUs[i] = NOT_REACHED;
+            noInterrupts();
+            _t0Us = t0Us;
+            _event = 0;
+            _running = true;
+            // Первый шаг уже просрочен: в паузе кадр начинается, как только позволяет SERVO_MIN_GAP_US
+            if (!_high)
+            {
+                uint32_t since = micros() - _lowStartUs;
+                timer1_write((since >= SERVO_MIN_GAP_US ? 10 : SERVO_MIN_GAP_US - since) * TICKS_PER_US);
+            }
+            interrupts();
+            _started = true;
+            _saved = false;
+        }
+
+        /**
+         * Прерывание программы (FLIGHT -> ARMED): стоп-импульс и отчет о
+         * выполненных шагах, если он еще не записан
+         */
+        void stop()
+        {
+            noInterrupts();
+            _running = false;
+            _pulseUs = SERVO_PULSE_STOP_US;
+            interrupts();
+            service();
+        }
+
+        /**
+         * Вызывается из задачи полета: отчет пишется, когда программа закончилась
+         */
+        void service()
+        {
+            if (_started && !_running && !_saved)
+                saveReport();
+        }
+
+        /**
+         * Номер полета для отчета (известен после открытия лога)
+         */
+        void setFlight(uint32_t flightId) { _flightId = flightId; }
+
+        bool isRunning() const { return _running; }
+
+        void serialize(JsonObject &doc) const
+        {
+            doc["pin"] = _pin;
+            doc["steps"] = _program.count;
+            doc["running"] = _running;
+            doc["pulse_us"] = _pulseUs;
+            if (_started)
+            {
+                doc["flight"] = _flightId;
+                doc["done"] = _event;
+                doc["max_error_us"] = maxErrorUs();
+            }
+        }
+    };
+
+    ServoExecutor servo;
+
+    void IRAM_ATTR onServoTimer()
+    {
+        servo.onTimer();
+    }
+
+    void ServoExecutor::begin(Config::Pin pin)
+    {
+        _pin = pin;
+        pinMode(_pin, OUTPUT);
+        digitalWrite(_pin, LOW);
+        _high = false;
+        _lowStartUs = micros();
+        timer1_attachInterrupt(onServoTimer);
+        timer1_enable(TIM_DIV16, TIM_EDGE, TIM_SINGLE);
+        timer1_write(SERVO_FRAME_US * TICKS_PER_US);
+        Serial.printf("[Servo] PWM на GPIO %d\n", _pin);
+    }
+}
+
+#endif
@@ -32,9 +32,96 @@ const unsigned long DOUBLE_CLICK_MS = 500;
 // Настройки сенсоров
 const unsigned long BARO_INTERVAL = 500;
 const int STABLE_THRESHOLD = 5;
+const uint8_t BMP180_OSS = 3;           // Оверсэмплинг BMP180 (3 = Ultra High Resolution)
+// Время преобразования BMP180 (мкс) с запасом относительно даташита
+constexpr uint32_t BMP180_TEMP_CONVERSION_US = 4600;
+constexpr uint32_t BMP180_PRESSURE_CONVERSION_US[4] = {4600, 7600, 13600, 25600};
+const uint32_t BARO_TICK_MARGIN_US = 3000; // Запас на опоздание колбэков Ticker за проходом loop()
+// Период отсчетов по таймеру: цикл температура+давление, каждая фаза ждется
+// через once_ms и округляется вверх до миллисекунды (при OSS 3: 5 + 26 + 3 = 34 мс)
+const uint32_t BARO_SAMPLE_PERIOD_US =
+    ((BMP180_TEMP_CONVERSION_US + 999) / 1000 + (BMP180_PRESSURE_CONVERSION_US[BMP180_OSS] + 999) / 1000) * 1000 +
+    BARO_TICK_MARGIN_US;
+const uint32_t I2C_CLOCK_HZ = 400000;   // Fast-mode I2C: чтение результата укладывается в ~0.1 мс
+const uint32_t BARO_TEMP_INTERVAL = 1000; // Период пересчета температурной компенсации B5, мс
+const size_t SAMPLE_RING_CAPACITY = 64;   // Отсчетов давления на один интервал расчета высоты
+const size_t CALIB_BLOCK_SAMPLES = 20;    // Размер блока робастного усреднения при калибровке/обнулении
+const uint32_t CALIB_MIN_SAMPLES = 200;   // Калибровка: не короче (защита от случайно малой дисперсии)
+const uint32_t CALIB_MAX_SAMPLES = 2000;  // Калибровка: не длиннее (прежний фиксированный объем)
+const float CALIB_SEM_THRESHOLD_PA = 0.25; // Калибровка завершается, когда ошибка среднего ниже порога
+const uint32_t CALIB_SAMPLE_PERIOD_US = BARO_SAMPLE_PERIOD_US; // Темп отсчетов калибровки/обнуления (~29 Гц)
+const uint32_t SENSOR_LOOP_BUDGET_US = 700;    // Бюджет сенсорной подсистемы на один проход loop()
+
+// Кооперативный планировщик loop(): период и бюджет задач
+#include "SchedulerTiming.h"
+static_assert(SENSOR_LOOP_BUDGET_US < TASK_SENSORS_PERIOD_US, "Sensors task must leave room for lower-priority tasks");
+
+// Прогрев: завершается, когда производная температуры держится ниже порога
+const unsigned long WARMUP_MIN_MS = 3000;
+const unsigned long WARMUP_MAX_MS = 10000;
+const unsigned long WARMUP_WINDOW_MS = 1000;  // Окно оценки dT/dt
+const uint32_t WARMUP_TEMP_INTERVAL = 250;    // Период измерения температуры во время прогрева, мс
+const uint32_t WARMUP_SAMPLE_PERIOD_US = 50000;
+const float WARMUP_SETTLED_SLOPE = 0.02;      // °C/с
+const int WARMUP_SETTLED_WINDOWS = 3;         // Подряд идущих "спокойных" окон
+
+// Фильтр высоты в целых числах с установившимися коэффициентами (без float на отсчет)
+// #define KALMAN_FIXED_POINT
+
+// Диагностика: раскомментировать для замера ядер в циклах CPU при старте
+// #define KERNEL_BENCH
+
+// Диагностика: замер задержки пуска (фронт магнита -> первое действие программы), /system/launch
+// #define LAUNCH_LATENCY
+const unsigned long LAUNCH_PERSIST_DELAY_MS = 2000; // Сохранение замера после первого действия, мс
 
 // Файлы системы
 #define CALIB_FILE "/calib.json"
 #define PINS_FILE "/pins.json"
+#define LOG_FILE_PREFIX "/log_"
+#define LOG_INDEX_FILE "/logs.idx"
+#define LAUNCH_FILE "/launch.bin"
+#define PROGRAM_FILE "/program.json"
+#define SERVO_REPORT_PREFIX "/servo_"
+
+// Сервопривод постоянного вращения: импульс задает направление, PWM от timer1
+const uint16_t SERVO_PULSE_STOP_US = 1500;
+const uint16_t SERVO_PULSE_CW_US = 2000;  // direction = 1
+const uint16_t SERVO_PULSE_CCW_US = 1000; // direction = -1
+const uint32_t SERVO_FRAME_US = 20000;    // Период импульсов 50 Гц
+const uint32_t SERVO_MIN_GAP_US = 3000;   // Кадр укорачивается под шаг программы, но пауза не короче
+const uint8_t SERVO_MAX_STEPS = 32;
+
+// Бортовой самописец
+const uint16_t LOG_MAX_RATE_HZ = 1000000 / BARO_SAMPLE_PERIOD_US; // Чаще барометр не измеряет
+const uint8_t LOG_SYNC_PAGES = 8;      // Синхронизация метаданных LittleFS раз в N страниц
+const uint8_t LOG_RECOVERY_MAX_BLOCKS = 4; // Блоков с конца, проверяемых при восстановлении
+
+// Предзапись в ARMED: последние PRETRIGGER_MS до старта попадают в лог с t < 0
+const uint16_t PRETRIGGER_RATE_HZ = 25; // Не выше частоты отсчетов барометра
+const uint16_t PRETRIGGER_MS = 3000;
+const size_t PRETRIGGER_DEPTH = (uint32_t)PRETRIGGER_MS * PRETRIGGER_RATE_HZ / 1000; // 16 байт на запись
+
+// Расписание частоты записи по времени полета: часто на старте, редко в планировании
+struct LogRateStep
+{
+    uint32_t untilMs; // Ступень действует до этого времени от старта
+    uint16_t rateHz;
+};
+const LogRateStep LOG_RATE_SCHEDULE[] = {
+    {5000, 25},
+    {35000, 10},
+    {UINT32_MAX, 1}};
+
+// Частая запись при заметной вертикальной скорости (термик, сваливание); 0 — выключено
+const uint16_t LOG_BOOST_RATE_HZ = 10;
+const float LOG_BOOST_VSPEED = 1.5; // м/с
+const uint16_t LOG_BOOST_HOLD_MS = 2000;
+
+// Запись полета в сырое флеш-кольцо под LittleFS (предсказуемая задержка записи),
+// экспорт в log_N.dat на земле
+// #define LOG_FLASH_RING
+const uint16_t FLASH_RING_SECTORS = 32; // 128 КБ
+const uint8_t FLASH_RING_PREERASE = 8;  // Секторов, стираемых заранее в ARMED
 
 #endif
\ No newline at end of file
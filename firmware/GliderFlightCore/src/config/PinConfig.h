@@ -18,6 +18,7 @@ namespace Config
         Pin led = 16; // Светодиод
         Pin sda = 4;  // I2C SDA
         Pin scl = 5;  // I2C SCL
+        Pin servo = 14; // Сигнал сервопривода (PWM от timer1)
 
         void loadDefaults()
         {
@@ -25,6 +26,7 @@ namespace Config
             led = 16;
             sda = 4;
             scl = 5;
+            servo = 14;
         }
 
         String serialize() const
@@ -34,6 +36,7 @@ namespace Config
             doc["led"] = led;
             doc["sda"] = sda;
             doc["scl"] = scl;
+            doc["servo"] = servo;
             String output;
             serializeJson(doc, output);
             return output;
@@ -52,6 +55,7 @@ namespace Config
             led = doc["led"] | led;
             sda = doc["sda"] | sda;
             scl = doc["scl"] | scl;
+            servo = doc["servo"] | servo;
             return true;
         }
     };
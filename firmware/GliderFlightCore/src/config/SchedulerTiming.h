@@ -0,0 +1,14 @@
+#ifndef SCHEDULER_TIMING_H
+#define SCHEDULER_TIMING_H
+
+#include <stdint.h>
+
+// Кооперативный планировщик loop() (core/Scheduler.h): период и бюджет задач, мкс.
+// Без зависимостей от ядра Arduino: эти же значения берет модель tools/launchsim.
+const uint32_t TASK_SENSORS_PERIOD_US = 1000;
+const uint32_t TASK_FLIGHT_PERIOD_US = 2000;
+const uint32_t TASK_FLIGHT_BUDGET_US = 3000;  // Запись страницы лога укладывается с запасом
+const uint32_t TASK_NETWORK_PERIOD_US = 5000;
+const uint32_t TASK_NETWORK_BUDGET_US = 20000;
+
+#endif
@@ -57,6 +57,10 @@ namespace Flight
         _isHolding = false;
         if (_readyForFlightRelease)
         {
+            launchTime = now;
+            launchEdgeUs = _edgeUs;
+            Diagnostics::launchLatency.start(_edgeUs);
+            Diagnostics::launchLatency.mark(Diagnostics::LAUNCH_DECISION);
             currentMode->onRelease(true);
             _readyForFlightRelease = false;
         }
@@ -3,20 +3,50 @@
 
 #include <Arduino.h>
 #include "../config/Config.h"
+#include "../utils/SpscQueue.h"
+#include "../diagnostics/LaunchLatency.h"
 #include "fsm/FlightMode.h"
 
 namespace Flight
 {
+    /**
+     * Фронт сигнала датчика Холла, снятый в прерывании
+     */
+    struct HallEdge
+    {
+        uint32_t us;   // micros() в момент фронта
+        uint8_t level; // Уровень после фронта
+    };
+
+    /**
+     * Датчик Холла (магнит-кнопка): нажатие, удержание, двойной клик.
+     *
+     * Фронты ловит прерывание GPIO (CHANGE) и кладет с меткой времени в мкс в
+     * очередь без блокировок; update() разбирает очередь и ведет логику по
+     * времени самих фронтов. Поэтому длинный проход loop() не сдвигает момент
+     * пуска и не съедает короткие клики — они дождутся в очереди.
+     */
     class HallSensorHandler
     {
     private:
+        static const size_t EDGE_QUEUE_SIZE = 16;
+
         Pin _pin;
+        Utils::SpscQueue<HallEdge, EDGE_QUEUE_SIZE> _edges;
         bool _lastState = HIGH;
         unsigned long _pressStartTime = 0;
         unsigned long _lastReleaseTime = 0;
         bool _isHolding = false;
         bool _readyForFlightRelease = false;
         int _clickCount = 0;
+        uint32_t _edgeUs = 0; // micros() обрабатываемого фронта
+
+        static void IRAM_ATTR onEdge(void *arg)
+        {
+            HallSensorHandler *self = (HallSensorHandler *)arg;
+            HallEdge edge = {(uint32_t)micros(), (uint8_t)digitalRead(self->_pin)};
+            self->_edges.push(edge);
+        }
 
         void processPress(unsigned long now)
         {
@@ -29,27 +59,60 @@ namespace Flight
         void processRelease(unsigned long now, FlightMode *currentMode);
         void processClickTimeout(unsigned long now, FlightMode *currentMode);
 
+        /**
+         * Смена уровня в момент t (мс, шкала millis)
+         */
+        void processLevel(bool state, unsigned long t, FlightMode *currentMode)
+        {
+            if (state == _lastState)
+                return;
+            _lastState = state;
+            if (state == LOW)
+            {
+                processPress(t);
+                return;
+            }
+            // Удержание проверяется на момент отпускания: проход loop() мог его пропустить
+            if (_isHolding)
+                handleHolding(t, currentMode);
+            processRelease(t, currentMode);
+        }
+
     public:
         HallSensorHandler(Pin pin) : _pin(pin) {}
         void init()
         {
             pinMode(_pin, INPUT_PULLUP);
             _lastState = digitalRead(_pin);
-            Serial.printf("[Flight] Hall sensor initialized on GPIO %d\n", _pin);
+            attachInterruptArg(digitalPinToInterrupt(_pin), onEdge, this, CHANGE);
+            Serial.printf("[Flight] Hall sensor initialized on GPIO %d (interrupt)\n", _pin);
         }
         void update(unsigned long now, FlightMode *currentMode)
         {
-            bool currentState = digitalRead(_pin);
-            if (currentState == LOW && _lastState == HIGH)
-                processPress(now);
+            uint32_t nowUs = micros();
+            HallEdge edge;
+            while (_edges.pop(edge))
+            {
+                // Фронт, пришедший уже во время разбора, новее nowUs: возраст 0, а не ~71 мин
+                int32_t ageUs = (int32_t)(nowUs - edge.us);
+                if (ageUs < 0)
+                    ageUs = 0;
+                _edgeUs = edge.us;
+                processLevel(edge.level, now - ageUs / 1000, currentMode);
+            }
+
+            // Фронт мог потеряться при переполнении очереди — сверка с выводом
+            if (_edges.empty())
+            {
+                _edgeUs = nowUs;
+                processLevel(digitalRead(_pin), now, currentMode);
+            }
+
             if (_isHolding)
                 handleHolding(now, currentMode);
-            if (currentState == HIGH && _lastState == LOW)
-                processRelease(now, currentMode);
             processClickTimeout(now, currentMode);
-            _lastState = currentState;
         }
     };
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -8,6 +8,8 @@
 #include "../network/handlers/ControlHandler.h"
 #include "../network/handlers/ProgramHandler.h"
 #include "../network/handlers/SystemHandler.h"
+#include "../network/handlers/LogsHandler.h"
+#include <uri/UriBraces.h>
 
 namespace Network
 {
@@ -21,6 +23,24 @@ namespace Network
     void handleLogControl();
     void handleProgramUpload();
     void handleSystem();
+    void handleSystemPerf();
+    void handleLaunchLatency();
+    void handleLogList();
+    void handleLogDownload();
+    void handleLogSummary();
+
+    /**
+     * Обработчик с замером времени (участок профилировщика с именем маршрута)
+     */
+    ESP8266WebServer::THandlerFunction profiled(const char *name, void (*handler)())
+    {
+        uint8_t probe = Diagnostics::profiler.add(name);
+        return [probe, handler]()
+        {
+            Diagnostics::PerfScope perf(probe);
+            handler();
+        };
+    }
 
     /**
      * Регистрация всех API маршрутов (Extract Method)
@@ -28,16 +48,25 @@ namespace Network
     void registerRoutes()
     {
         Serial.println("[WebServer] Регистрация эндпоинтов...");
-        server.on("/status", HTTP_GET, handleStatus);
-        server.on("/system", HTTP_GET, handleSystem);
-        server.on("/calibrate", HTTP_GET, handleCalibrate);
-        server.on("/cancel", HTTP_GET, handleCancel);
-        server.on("/calibrate/save", HTTP_GET, handleSaveCalib);
-        server.on("/zero", HTTP_GET, handleZero);
-        server.on("/baro", HTTP_GET, handleBaroControl);
-        server.on("/log", HTTP_GET, handleLogControl);
-        server.on("/program", HTTP_POST, handleProgramUpload);
+        server.on("/status", HTTP_GET, profiled("GET /status", handleStatus));
+        server.on("/system", HTTP_GET, profiled("GET /system", handleSystem));
+        server.on("/system/perf", HTTP_GET, handleSystemPerf);
+        server.on("/system/launch", HTTP_GET, handleLaunchLatency);
+        server.on("/calibrate", HTTP_GET, profiled("GET /calibrate", handleCalibrate));
+        server.on("/cancel", HTTP_GET, profiled("GET /cancel", handleCancel));
+        server.on("/calibrate/save", HTTP_GET, profiled("GET /calibrate/save", handleSaveCalib));
+        server.on("/zero", HTTP_GET, profiled("GET /zero", handleZero));
+        server.on("/baro", HTTP_GET, profiled("GET /baro", handleBaroControl));
+        server.on("/log", HTTP_GET, profiled("GET /log", handleLogControl));
+        server.on("/program", HTTP_POST, profiled("POST /program", handleProgramUpload));
+        server.on("/logs", HTTP_GET, profiled("GET /logs", handleLogList));
+        server.on(UriBraces("/logs/{}"), HTTP_GET, profiled("GET /logs/<n>", handleLogDownload));
+        server.on(UriBraces("/logs/{}/summary"), HTTP_GET, profiled("GET /logs/<n>/summary", handleLogSummary));
         server.onNotFound(handleNotFound);
+
+        // Заголовки, которые сервер сохраняет для обработчиков
+        static const char *headers[] = {"Range"};
+        server.collectHeaders(headers, 1);
     }
 
     /**
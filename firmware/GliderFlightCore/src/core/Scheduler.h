@@ -0,0 +1,146 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "../config/Config.h"
+#include "../diagnostics/Profiler.h"
+
+namespace Scheduler
+{
+    /**
+     * Кооперативный планировщик задач loop().
+     *
+     * Задача — функция с периодом, приоритетом, бюджетом времени и маской
+     * режимов полета, в которых она работает. За проход loop() выполняется
+     * одна задача: самая приоритетная из тех, чей срок подошел. Так задачи
+     * полета всегда обслуживаются раньше сети, а медленный HTTP-клиент
+     * задерживает их не больше чем на один свой проход.
+     *
+     * Строгий приоритет без старения позволял бы частой задаче, которая
+     * дольше своего периода, занимать каждый проход. Поэтому задача, опоздавшая
+     * больше чем на STARVATION_PERIODS периодов, выигрывает проход у более
+     * приоритетных. Граница ожидания любой задачи — (STARVATION_PERIODS + 1)
+     * ее периода плюс один проход самой долгой задачи (и проходы других
+     * голодающих задач выше ее по приоритету). Такие запуски считаются в starved.
+     *
+     * Вытеснения нет: задача, превысившая бюджет, досчитывается до конца,
+     * превышение только учитывается (overruns, max_us) и видно в /system.
+     * Распределение времени задачи — в /system/perf (участок с ее именем).
+     */
+    typedef void (*TaskFn)();
+
+    const uint8_t MAX_TASKS = 8;
+    const uint8_t ALL_MODES = 0xFF;
+    const uint8_t STARVATION_PERIODS = 2;
+
+    inline uint8_t modeBit(Config::FlightState state) { return 1 << state; }
+
+    struct Task
+    {
+        const char *name;
+        TaskFn fn;
+        uint32_t periodUs;
+        uint32_t budgetUs;
+        uint8_t priority; // 0 — наивысший
+        uint8_t modes;    // Биты modeBit(): в каких режимах задача выполняется
+        uint8_t probe;    // Участок профилировщика
+
+        uint32_t lastUs;
+        uint32_t runs;
+        uint32_t overruns;
+        uint32_t maxUs;
+        uint32_t maxLateUs; // Наибольшее опоздание старта относительно срока
+        uint32_t starved;   // Запусков в обход более приоритетных задач
+    };
+
+    Task tasks[MAX_TASKS];
+    uint8_t taskCount = 0;
+
+    /**
+     * Регистрация задачи; список держится отсортированным по приоритету
+     * (при равном — в порядке регистрации)
+     */
+    bool add(const char *name, TaskFn fn, uint32_t periodUs, uint8_t priority, uint32_t budgetUs, uint8_t modes = ALL_MODES)
+    {
+        if (taskCount >= MAX_TASKS)
+            return false;
+        uint8_t pos = taskCount;
+        while (pos > 0 && tasks[pos - 1].priority > priority)
+        {
+            tasks[pos] = tasks[pos - 1];
+            pos--;
+        }
+        tasks[pos] = {name, fn, periodUs, budgetUs, priority, modes, Diagnostics::profiler.add(name), (uint32_t)micros() - periodUs, 0, 0, 0, 0, 0};
+        taskCount++;
+        return true;
+    }
+
+    /**
+     * Выполняет голодающую задачу, а если таких нет — самую приоритетную
+     * со сроком; false, если срок не подошел ни у одной
+     */
+    bool run(Config::FlightState mode)
+    {
+        uint32_t now = micros();
+        Task *next = nullptr;
+        bool starving = false;
+        bool bypass = false; // Голодающая задача обходит уже найденную более приоритетную
+        for (uint8_t i = 0; i < taskCount && !starving; i++)
+        {
+            Task &task = tasks[i];
+            if (!(task.modes & modeBit(mode)))
+            {
+                // Выключенная режимом задача при возврате стартует сразу и без "опоздания"
+                task.lastUs = now - task.periodUs;
+                continue;
+            }
+            uint32_t since = now - task.lastUs;
+            if (since < task.periodUs)
+                continue;
+            starving = since - task.periodUs > STARVATION_PERIODS * task.periodUs;
+            bypass = starving && next;
+            if (!next || starving)
+                next = &task;
+        }
+        if (!next)
+            return false;
+
+        Task &task = *next;
+        // Задача, пропустившая несколько периодов, не догоняет их
+        task.maxLateUs = max(task.maxLateUs, now - task.lastUs - task.periodUs);
+        task.lastUs = now;
+        if (bypass)
+            task.starved++;
+        {
+            Diagnostics::PerfScope perf(task.probe);
+            task.fn();
+        }
+        uint32_t elapsed = micros() - now;
+        task.runs++;
+        task.maxUs = max(task.maxUs, elapsed);
+        if (elapsed > task.budgetUs)
+            task.overruns++;
+        return true;
+    }
+
+    void serialize(JsonArray &doc)
+    {
+        for (uint8_t i = 0; i < taskCount; i++)
+        {
+            const Task &task = tasks[i];
+            JsonObject item = doc.createNestedObject();
+            item["name"] = task.name;
+            item["priority"] = task.priority;
+            item["period_us"] = task.periodUs;
+            item["budget_us"] = task.budgetUs;
+            item["runs"] = task.runs;
+            item["overruns"] = task.overruns;
+            item["max_us"] = task.maxUs;
+            item["max_late_us"] = task.maxLateUs;
+            item["starved"] = task.starved;
+        }
+    }
+}
+
+#endif
@@ -9,6 +9,7 @@
 
 // Остальные драйверы и математика
 #include "../sensors/BarometerDriver.h"
+#include "../sensors/SamplingScheduler.h"
 #include "../sensors/KalmanFilter.h"
 #include "../sensors/CalibrationData.h"
 #include "../sensors/AltitudeCalculator.h"
@@ -23,8 +24,19 @@ namespace Sensors
     {
         sys.serialize(doc);
         currentState->serialize(doc);
-        doc["stored_base"] = calData.storedBasePressure;
-        doc["base"] = calData.basePressure;
+        doc["stored_base"] = toPascals(calData.storedBasePressure);
+        doc["base"] = toPascals(calData.basePressure);
+        if (!currentState->isIdle())
+        {
+            doc["calib_rate"] = calibRate.rate();
+            doc["sensor_loop_max_us"] = sensorLoopMaxUs;
+        }
+        else if (calData.samples)
+        {
+            doc["calib_noise"] = calData.noisePa;
+            doc["calib_sem"] = calData.semPa;
+            doc["calib_samples"] = calData.samples;
+        }
         telemetry.serialize(doc, sys.calibrated, sys.monitoring);
     }
 
@@ -37,13 +49,57 @@ namespace Sensors
 
     void cancelCalibration() { cancel(); }
 
+    /**
+     * Барометр опрашивается только когда его данные кому-то нужны
+     */
+    bool isBarometerActive()
+    {
+        return sys.hardwareOK && (sys.monitoring || !currentState->isIdle());
+    }
+
+    /**
+     * Отсчет уходит либо активному состоянию калибровки, либо в расчет высоты
+     */
+    void dispatchSample(const BaroSample &sample)
+    {
+        if (currentState->isMeasuring())
+        {
+            calibRate.add(sample.timestamp);
+            currentState->onSample(sample);
+        }
+        else
+        {
+            addAltitudeSample(sample);
+        }
+    }
+
+    /**
+     * Один проход сенсорной подсистемы, ограниченный SENSOR_LOOP_BUDGET_US.
+     * Отсчеты производит таймер (SamplingScheduler); здесь очередь готовых
+     * отсчетов разбирается, пока не исчерпан бюджет, остальные ждут следующего
+     * прохода loop(), чтобы веб-сервер и датчик Холла не голодали.
+     */
     void update()
     {
+        LoopBudget budget(SENSOR_LOOP_BUDGET_US);
+        if (isBarometerActive())
+            sampling.start(currentState->samplePeriodUs());
+        else
+            sampling.stop();
+
+        BaroSample sample;
+        while (!budget.exhausted() && takeSample(sample))
+            dispatchSample(sample);
+
         updateCalibrationLogic();
         if (!currentState->isMeasuring())
         {
             updateAltitude();
         }
+        else
+        {
+            sensorLoopMaxUs = max(sensorLoopMaxUs, budget.elapsed());
+        }
     }
 }
 #endif
\ No newline at end of file
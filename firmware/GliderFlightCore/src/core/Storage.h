@@ -81,7 +81,17 @@ namespace Storage
 
     bool saveProgram(String json)
     {
-        return writeFile("/program.json", json, "Program");
+        return writeFile(PROGRAM_FILE, json, "Program");
+    }
+
+    String loadProgram()
+    {
+        File file = LittleFS.open(PROGRAM_FILE, "r");
+        if (!file)
+            return "";
+        String json = file.readString();
+        file.close();
+        return json;
     }
 
     bool saveCalibration(String json)
@@ -109,5 +119,48 @@ namespace Storage
         file.close();
         return data;
     }
+
+    // --- Полетные логи ---
+
+    String logPath(uint32_t id)
+    {
+        return String(LOG_FILE_PREFIX) + String(id) + ".dat";
+    }
+
+    /**
+     * Номер лога по имени файла "log_N.dat" (0, если это не лог)
+     */
+    uint32_t logIdFromName(String name)
+    {
+        if (name.startsWith("/"))
+            name = name.substring(1);
+        if (!name.startsWith("log_") || !name.endsWith(".dat"))
+            return 0;
+        return name.substring(4).toInt();
+    }
+
+    /**
+     * Следующий свободный номер лога (максимальный существующий + 1)
+     */
+    uint32_t findNextLogId()
+    {
+        uint32_t next = 1;
+        Dir dir = LittleFS.openDir("/");
+        while (dir.next())
+        {
+            uint32_t id = logIdFromName(dir.fileName());
+            if (id >= next)
+                next = id + 1;
+        }
+        return next;
+    }
+
+    File createLog(uint32_t id)
+    {
+        File file = LittleFS.open(logPath(id), "w");
+        if (!file)
+            Serial.printf("[FS] Failed to create log %u\n", id);
+        return file;
+    }
 }
 #endif
\ No newline at end of file
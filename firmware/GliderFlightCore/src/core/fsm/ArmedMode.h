@@ -4,6 +4,8 @@
 #include "FlightMode.h"
 #include <Arduino.h>
 #include "../../network/WiFiManager.h"
+#include "../../logging/FlightRecorder.h"
+#include "../../actuators/ServoExecutor.h"
 
 namespace Flight
 {
@@ -16,11 +18,14 @@ namespace Flight
             Serial.println("--- System Mode: ARMED (Ready to Launch) ---");
             if (oldState == STATE_FLIGHT)
                 Network::setupWiFi();
+            Logging::recorder.arm();
+            Actuators::servo.load();
         }
-        void update(unsigned long now) override {}
+        void update(unsigned long now) override { Logging::recorder.serviceArmed(); }
         void onDoubleClick() override
         {
             Serial.println("[Flight] Возврат: ARMED -> SETUP");
+            Logging::recorder.disarm();
             transitionTo((FlightMode *)&setupModeObj);
         }
         void onRelease(bool wasReady) override
@@ -21,6 +21,10 @@ namespace Flight
         virtual FlightState getType() = 0;
     };
 
+    // Момент пуска (мс, шкала millis): фронт отпускания магнита, а не момент его обработки
+    unsigned long launchTime = 0;
+    uint32_t launchEdgeUs = 0; // Тот же фронт в micros()
+
     // Опережающее объявление функции перехода
     void transitionTo(FlightMode *newMode);
 
@@ -4,6 +4,9 @@
 #include "FlightMode.h"
 #include <Arduino.h>
 #include "../../network/WiFiManager.h"
+#include "../../logging/FlightRecorder.h"
+#include "../../diagnostics/LaunchLatency.h"
+#include "../../actuators/ServoExecutor.h"
 
 namespace Flight
 {
@@ -13,13 +16,28 @@ namespace Flight
         FlightState getType() override { return STATE_FLIGHT; }
         void onEnter(FlightState oldState) override
         {
+            Diagnostics::launchLatency.mark(Diagnostics::LAUNCH_TRANSITION);
             Serial.println("--- System Mode: FLIGHT (Wi-Fi OFF) ---");
             Network::stopWiFi();
+            Diagnostics::launchLatency.mark(Diagnostics::LAUNCH_WIFI_OFF);
+            // Программа сервопривода — раньше открытия лога: сроки шагов идут от фронта пуска
+            Actuators::servo.start(launchEdgeUs);
+            Diagnostics::launchLatency.mark(Diagnostics::LAUNCH_FIRST_ACTION);
+            Logging::recorder.start(launchTime);
+            Actuators::servo.setFlight(Logging::recorder.flightId());
+        }
+        void update(unsigned long now) override
+        {
+            Diagnostics::launchLatency.service(now);
+            Actuators::servo.service();
+            Logging::recorder.service(now);
         }
-        void update(unsigned long now) override {}
         void onDoubleClick() override
         {
             Serial.println("[Flight] Прерывание: FLIGHT -> ARMED");
+            Actuators::servo.stop();
+            Logging::recorder.stop();
+            Diagnostics::launchLatency.persist();
             transitionTo((FlightMode *)&armedModeObj);
         }
     };
@@ -0,0 +1,139 @@
+#ifndef KERNEL_BENCH_H
+#define KERNEL_BENCH_H
+
+#include <Arduino.h>
+#include "../sensors/AltitudeKernel.h"
+#include "../sensors/Pressure.h"
+#include "../logging/LogCodec.h"
+
+namespace Diagnostics
+{
+    // Приемник результатов, чтобы компилятор не выбросил замеряемый код
+    volatile float benchSink = 0;
+
+    const int BENCH_ITERATIONS = 1000;
+
+    /**
+     * Среднее число тактов CPU на один вызов fn(ratio) по сетке отношений давления
+     */
+    template <typename Fn>
+    uint32_t cyclesPerCall(Fn fn)
+    {
+        uint32_t start = ESP.getCycleCount();
+        for (int i = 0; i < BENCH_ITERATIONS; i++)
+        {
+            float ratio = 0.9f + 0.2f * i / BENCH_ITERATIONS;
+            benchSink = fn(ratio);
+        }
+        return (ESP.getCycleCount() - start) / BENCH_ITERATIONS;
+    }
+
+    /**
+     * Микробенчмарк ядер расчета высоты: pow() против табличного ядра.
+     */
+    void runAltitudeBench()
+    {
+        Serial.println("[Bench] Altitude kernel, cycles/call:");
+
+        uint32_t baseline = cyclesPerCall([](float r)
+                                          { return r; });
+        uint32_t powCycles = cyclesPerCall([](float r)
+                                           { return (float)(44330.0 * (1.0 - pow(r, 0.190295))); });
+        uint32_t kernelCycles = cyclesPerCall([](float r)
+                                              { return Sensors::altitudeFromRatio(r); });
+
+        float maxError = 0;
+        for (int i = 0; i < BENCH_ITERATIONS; i++)
+        {
+            float ratio = 0.9f + 0.2f * i / BENCH_ITERATIONS;
+            float exact = 44330.0 * (1.0 - pow(ratio, 0.190295));
+            maxError = max(maxError, (float)fabs(Sensors::altitudeFromRatio(ratio) - exact));
+        }
+
+        Serial.printf("[Bench]   loop overhead: %u\n", baseline);
+        Serial.printf("[Bench]   pow():         %u\n", powCycles - baseline);
+        Serial.printf("[Bench]   table kernel:  %u\n", kernelCycles - baseline);
+        Serial.print("[Bench]   max error, m:  ");
+        Serial.println(maxError, 4);
+    }
+
+    // Синтетические отсчеты давления (Па) с шумом в несколько паскалей
+    int32_t benchPressure(int i) { return 101325 + (i * 7919) % 9 - 4; }
+
+    /**
+     * До/после перевода тракта давления на целые: накопление 2000 отсчетов
+     * (как в MeasuringState), усреднение, адаптация базы и отношение p/p0.
+     */
+    void runPipelineBench()
+    {
+        const int N = 2000;
+        Serial.println("[Bench] Pressure pipeline, cycles (2000 samples + 1 update):");
+
+        uint32_t start = ESP.getCycleCount();
+        double sumD = 0;
+        for (int i = 0; i < N; i++)
+            sumD += benchPressure(i);
+        double avgD = sumD / (double)N;
+        double baseD = 101300.5;
+        baseD = baseD * (1.0 - 0.001) + avgD * 0.001;
+        benchSink = avgD / baseD;
+        uint32_t doubleCycles = ESP.getCycleCount() - start;
+
+        start = ESP.getCycleCount();
+        int32_t sumI = 0;
+        for (int i = 0; i < N; i++)
+            sumI += benchPressure(i);
+        Sensors::PressureMilliPa avgI = Sensors::averageMilliPa(sumI, N);
+        Sensors::PressureMilliPa baseI = 101300500;
+        uint16_t baseFraction = 0;
+        Sensors::blendMilliPa(baseI, baseFraction, avgI, 66);
+        benchSink = (float)avgI / (float)baseI;
+        uint32_t intCycles = ESP.getCycleCount() - start;
+
+        Serial.printf("[Bench]   double (before): %u (%u/sample)\n", doubleCycles, doubleCycles / N);
+        Serial.printf("[Bench]   int32 mPa (after): %u (%u/sample)\n", intCycles, intCycles / N);
+    }
+
+    /**
+     * Дельта-кодер лога: такты на запись и степень сжатия на синтетическом
+     * наборе (набор высоты 5 м/с на 10 Гц, шум давления несколько Па).
+     */
+    void runCodecBench()
+    {
+        const int N = 1000;
+        uint8_t page[Logging::LOG_PAGE_SIZE];
+        Logging::PageEncoder encoder;
+        encoder.begin(page);
+        uint32_t bytes = 0, cycles = 0;
+
+        for (int i = 0; i < N; i++)
+        {
+            Logging::LogRecord rec = {i * 100, benchPressure(i) - i * 6, i * 50, 2150, Logging::REC_CALIBRATED, 0};
+            uint32_t start = ESP.getCycleCount();
+            if (!encoder.add(rec))
+            {
+                encoder.finish();
+                bytes += Logging::LOG_PAGE_SIZE;
+                encoder.begin(page);
+                encoder.add(rec);
+            }
+            cycles += ESP.getCycleCount() - start;
+        }
+        bytes += encoder.used();
+
+        Serial.printf("[Bench] Log codec: %u cycles/record, %u bytes for %d records (fixed: %u)\n",
+                      cycles / N, bytes, N, N * (uint32_t)sizeof(Logging::LogRecord));
+    }
+
+    /**
+     * Все замеры ядер. Включается флагом KERNEL_BENCH в Config.h, результат — в Serial.
+     */
+    void runKernelBench()
+    {
+        runAltitudeBench();
+        runPipelineBench();
+        runCodecBench();
+    }
+}
+
+#endif
@@ -0,0 +1,210 @@
+#ifndef LAUNCH_LATENCY_H
+#define LAUNCH_LATENCY_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <LittleFS.h>
+#include "Profiler.h"
+#include "../config/Config.h"
+
+namespace Diagnostics
+{
+    /**
+     * Этапы пуска, время каждого отсчитывается от фронта отпускания магнита
+     */
+    enum LaunchStage : uint8_t
+    {
+        LAUNCH_DECISION,     // processRelease() решил, что это пуск
+        LAUNCH_TRANSITION,   // Вход в FLIGHT (transitionTo)
+        LAUNCH_WIFI_OFF,     // Network::stopWiFi() завершен
+        LAUNCH_FIRST_ACTION, // Программа сервопривода запущена (шаг 1 поставлен таймеру)
+        LAUNCH_STAGES
+    };
+
+    /**
+     * Задержка пуска (сборка с LAUNCH_LATENCY). Фронт приходит из прерывания
+     * датчика Холла с меткой micros(), этапы отмечаются mark() по ходу пути
+     * FSM. После первого действия задержки этапов попадают в гистограммы
+     * (PerfProbe, мкс) и сохраняются в LAUNCH_FILE — статистика копится
+     * между включениями. Файл пишется из задачи полета через
+     * LAUNCH_PERSIST_DELAY_MS после первого действия — вне измеряемого пути
+     * и до посадки, которая часто заканчивается просто снятием питания.
+     * Без LAUNCH_LATENCY методы пустые.
+     */
+    class LaunchLatency
+    {
+    private:
+        static const uint32_t FILE_MAGIC = 0x4C4E434C; // "LCNL"
+        static const uint16_t FILE_VERSION = 3; // 3: гистограмма по четвертям октавы от 2^2
+
+        struct __attribute__((packed)) FileHeader
+        {
+            uint32_t magic;
+            uint16_t version;
+            uint16_t stages;
+            uint32_t launches;
+        };
+
+        PerfProbe _stages[LAUNCH_STAGES];
+        uint32_t _launches = 0;
+        uint32_t _edgeUs = 0;
+        uint32_t _lastUs[LAUNCH_STAGES];
+        uint8_t _marked = 0; // Биты отмеченных этапов текущего пуска
+        bool _active = false;
+        bool _dirty = false;
+        uint32_t _completedMs = 0;
+
+        void setNames()
+        {
+            static const char *const names[LAUNCH_STAGES] = {"decision", "transition", "wifi_off", "first_action"};
+            for (uint8_t i = 0; i < LAUNCH_STAGES; i++)
+                _stages[i].name = names[i];
+        }
+
+        void complete()
+        {
+            _active = false;
+            _launches++;
+            for (uint8_t i = 0; i < LAUNCH_STAGES; i++)
+                if (_marked & (1 << i))
+                    _stages[i].add(_lastUs[i]);
+            _dirty = true;
+            _completedMs = millis();
+            Serial.printf("[Launch] Задержка пуска: решение %u, FLIGHT %u, Wi-Fi выкл. %u, первое действие %u мкс\n",
+                          _lastUs[LAUNCH_DECISION], _lastUs[LAUNCH_TRANSITION], _lastUs[LAUNCH_WIFI_OFF], _lastUs[LAUNCH_FIRST_ACTION]);
+        }
+
+        void save()
+        {
+            File file = LittleFS.open(LAUNCH_FILE, "w");
+            if (!file)
+                return;
+            FileHeader header = {FILE_MAGIC, FILE_VERSION, LAUNCH_STAGES, _launches};
+            file.write((const uint8_t *)&header, sizeof(header));
+            file.write((const uint8_t *)_stages, sizeof(_stages));
+            file.close();
+        }
+
+    public:
+        /**
+         * Загрузка накопленной статистики. Вызывается в setup() после Storage::begin().
+         */
+        void begin()
+        {
+            reset();
+#ifdef LAUNCH_LATENCY
+            File file = LittleFS.open(LAUNCH_FILE, "r");
+            if (!file)
+                return;
+            FileHeader header;
+            if (file.read((uint8_t *)&header, sizeof(header)) == sizeof(header) && header.magic == FILE_MAGIC &&
+                header.version == FILE_VERSION && header.stages == LAUNCH_STAGES &&
+                file.read((uint8_t *)_stages, sizeof(_stages)) == sizeof(_stages))
+                _launches = header.launches;
+            else
+                reset();
+            file.close();
+            setNames(); // Указатели на имена из файла недействительны
+#endif
+        }
+
+        /**
+         * Начало замера: фронт отпускания магнита (micros() из прерывания)
+         */
+        void start(uint32_t edgeUs)
+        {
+#ifdef LAUNCH_LATENCY
+            _edgeUs = edgeUs;
+            _marked = 0;
+            _active = true;
+#endif
+        }
+
+        void mark(LaunchStage stage)
+        {
+#ifdef LAUNCH_LATENCY
+            if (!_active || (_marked & (1 << stage)))
+                return;
+            _lastUs[stage] = micros() - _edgeUs;
+            _marked |= 1 << stage;
+            if (stage == LAUNCH_FIRST_ACTION)
+                complete();
+#endif
+        }
+
+        /**
+         * Сохранение статистики после замера; вызывается из задачи полета
+         */
+        void service(unsigned long now)
+        {
+#ifdef LAUNCH_LATENCY
+            if (_dirty && now - _completedMs >= LAUNCH_PERSIST_DELAY_MS)
+                persist();
+#endif
+        }
+
+        /**
+         * Немедленное сохранение (полет прерван раньше задержки)
+         */
+        void persist()
+        {
+#ifdef LAUNCH_LATENCY
+            if (_dirty)
+            {
+                _dirty = false;
+                save();
+            }
+#endif
+        }
+
+        void reset()
+        {
+            for (uint8_t i = 0; i < LAUNCH_STAGES; i++)
+            {
+                _stages[i].reset();
+                _lastUs[i] = 0;
+            }
+            setNames();
+            _launches = 0;
+            _active = false;
+        }
+
+        /**
+         * Сброс статистики вместе с файлом
+         */
+        void clear()
+        {
+            reset();
+            LittleFS.remove(LAUNCH_FILE);
+        }
+
+        void serialize(JsonObject &doc) const
+        {
+#ifdef LAUNCH_LATENCY
+            doc["enabled"] = true;
+#else
+            doc["enabled"] = false;
+#endif
+            doc["launches"] = _launches;
+            JsonArray stages = doc.createNestedArray("stages");
+            for (uint8_t i = 0; i < LAUNCH_STAGES; i++)
+            {
+                const PerfProbe &p = _stages[i];
+                JsonObject item = stages.createNestedObject();
+                item["name"] = p.name;
+                item["count"] = p.count;
+                item["last_us"] = _lastUs[i];
+                if (p.count == 0)
+                    continue;
+                item["min_us"] = p.minCycles;
+                item["avg_us"] = (uint32_t)(p.sumCycles / p.count);
+                item["max_us"] = p.maxCycles;
+                item["p99_us"] = p.percentile(99);
+            }
+        }
+    };
+
+    LaunchLatency launchLatency;
+}
+
+#endif
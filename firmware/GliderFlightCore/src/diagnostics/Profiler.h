@@ -0,0 +1,179 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+namespace Diagnostics
+{
+    /**
+     * Профилировщик участков кода в тактах CPU (ESP.getCycleCount()).
+     *
+     * Точка замера — PerfScope на стеке: два чтения счетчика тактов и запись
+     * в гистограмму, т.е. доли микросекунды, поэтому замеры включены всегда.
+     * Память фиксирована: на участок min/max/сумма и логарифмическая гистограмма
+     * с PERF_SUB_BUCKETS корзинами на октаву (октава 2^k..2^(k+1) тактов делится
+     * на 4 равные части) от 2^2 до 2^24 тактов, так что во всем диапазоне от
+     * долей микросекунды до 210 мс при 80 МГц p99 завышается не больше чем на
+     * 25%, а не вдвое, как при корзинах по степеням двойки. Значения меньше
+     * 4 тактов попадают в первую корзину, больше 2^24 — в последнюю (ее
+     * граница — max). Гистограмма — 176 байт на участок. Счетчики 16-битные; когда
+     * корзина переполняется, все корзины участка делятся пополам с округлением
+     * вверх — форма распределения сохраняется, а редкие отсчеты хвоста (они
+     * и определяют p99) не обнуляются.
+     *
+     * Счетчик тактов 32-битный: участки длиннее ~53 с при 80 МГц не замеряются.
+     */
+    const uint8_t PERF_MAX_PROBES = 24;
+    const uint8_t PERF_SUB_BUCKETS = 4;
+    const uint8_t PERF_FIRST_OCTAVE = 2; // Младшая октава: в ней уже есть четыре различимых значения
+    const uint8_t PERF_BUCKETS = 88;     // 22 октавы: 2^2..2^24 тактов
+    const uint8_t PERF_NONE = 0xFF;
+
+    struct PerfProbe
+    {
+        const char *name;
+        uint32_t count;
+        uint32_t minCycles;
+        uint32_t maxCycles;
+        uint64_t sumCycles;
+        uint16_t hist[PERF_BUCKETS];
+
+        void reset()
+        {
+            count = maxCycles = 0;
+            minCycles = UINT32_MAX;
+            sumCycles = 0;
+            memset(hist, 0, sizeof(hist));
+        }
+
+        static uint8_t bucketOf(uint32_t cycles)
+        {
+            uint8_t octave = cycles ? 31 - __builtin_clz(cycles) : 0;
+            if (octave < PERF_FIRST_OCTAVE)
+                return 0;
+            // Два бита после старшего — номер четверти октавы
+            uint32_t bucket = (octave - PERF_FIRST_OCTAVE) * PERF_SUB_BUCKETS + ((cycles >> (octave - 2)) & 3);
+            return bucket < PERF_BUCKETS ? bucket : PERF_BUCKETS - 1;
+        }
+
+        /**
+         * Верхняя граница корзины (включительно), тактов
+         */
+        static uint32_t bucketTop(uint8_t bucket)
+        {
+            uint8_t octave = PERF_FIRST_OCTAVE + bucket / PERF_SUB_BUCKETS;
+            return ((uint32_t)(PERF_SUB_BUCKETS + bucket % PERF_SUB_BUCKETS + 1) << (octave - 2)) - 1;
+        }
+
+        void add(uint32_t cycles)
+        {
+            count++;
+            sumCycles += cycles;
+            minCycles = min(minCycles, cycles);
+            maxCycles = max(maxCycles, cycles);
+            uint8_t bucket = bucketOf(cycles);
+            if (hist[bucket] == UINT16_MAX)
+                for (uint8_t i = 0; i < PERF_BUCKETS; i++)
+                    hist[i] = (hist[i] + 1) >> 1;
+            hist[bucket]++;
+        }
+
+        /**
+         * Верхняя граница корзины, в которую попадает процентиль pct, тактов
+         */
+        uint32_t percentile(uint8_t pct) const
+        {
+            uint32_t total = 0;
+            for (uint8_t i = 0; i < PERF_BUCKETS; i++)
+                total += hist[i];
+            if (total == 0)
+                return 0;
+            uint32_t above = total * (100 - pct) / 100; // Допустимо отсчетов выше процентиля
+            uint32_t seen = 0;
+            for (int8_t i = PERF_BUCKETS - 1; i > 0; i--)
+            {
+                seen += hist[i];
+                if (seen > above)
+                    return min(maxCycles, i == PERF_BUCKETS - 1 ? maxCycles : bucketTop(i));
+            }
+            return min(maxCycles, bucketTop(0));
+        }
+    };
+
+    class Profiler
+    {
+    private:
+        PerfProbe _probes[PERF_MAX_PROBES];
+        uint8_t _count = 0;
+        unsigned long _since = 0;
+
+        static float toUs(uint32_t cycles) { return (float)cycles / ESP.getCpuFreqMHz(); }
+
+    public:
+        /**
+         * Регистрирует участок; PERF_NONE, если место кончилось (замеры игнорируются)
+         */
+        uint8_t add(const char *name)
+        {
+            if (_count >= PERF_MAX_PROBES)
+                return PERF_NONE;
+            _probes[_count].name = name;
+            _probes[_count].reset();
+            return _count++;
+        }
+
+        void record(uint8_t id, uint32_t cycles)
+        {
+            if (id < _count)
+                _probes[id].add(cycles);
+        }
+
+        void reset()
+        {
+            for (uint8_t i = 0; i < _count; i++)
+                _probes[i].reset();
+            _since = millis();
+        }
+
+        uint8_t size() const { return _count; }
+        unsigned long since() const { return _since; }
+
+        void serialize(uint8_t id, JsonObject &doc) const
+        {
+            const PerfProbe &p = _probes[id];
+            doc["name"] = p.name;
+            doc["count"] = p.count;
+            if (p.count == 0)
+                return;
+            doc["min_us"] = toUs(p.minCycles);
+            doc["avg_us"] = toUs((uint32_t)(p.sumCycles / p.count));
+            doc["max_us"] = toUs(p.maxCycles);
+            doc["p99_us"] = toUs(p.percentile(99));
+            doc["total_ms"] = toUs((uint32_t)(p.sumCycles / 1000));
+        }
+    };
+
+    Profiler profiler;
+
+    /**
+     * Замер участка от конструктора до выхода из области видимости
+     */
+    class PerfScope
+    {
+    private:
+        uint8_t _id;
+        uint32_t _start;
+
+    public:
+        PerfScope(uint8_t id) : _id(id), _start(ESP.getCycleCount()) {}
+        ~PerfScope() { profiler.record(_id, ESP.getCycleCount() - _start); }
+    };
+
+    // Участки нижнего уровня; задачи loop() и HTTP-обработчики регистрируются при подключении
+    const uint8_t PERF_BARO_READ = profiler.add("baro_read");
+    const uint8_t PERF_FILTER = profiler.add("altitude_filter");
+    const uint8_t PERF_FS_WRITE = profiler.add("log_write");
+}
+
+#endif
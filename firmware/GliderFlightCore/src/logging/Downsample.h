@@ -0,0 +1,233 @@
+#ifndef DOWNSAMPLE_H
+#define DOWNSAMPLE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace Logging
+{
+    // Приемник выбранных точек (время, мс; значение)
+    typedef void (*PointSink)(int32_t t, int32_t value, void *context);
+
+    /**
+     * Прореживание ряда методом Largest-Triangle-Three-Buckets за один проход.
+     *
+     * Записи между первой и последней делятся на points - 2 корзины равного
+     * числа записей (общее число total известно заранее: из индекса лога или
+     * счетным проходом). Корзины равной длительности на логе с переменной
+     * частотой давали вдвое меньше точек: в редко записанном планировании
+     * корзины пустели. Из каждой корзины берется точка, образующая наибольший треугольник с уже выбранной точкой
+     * предыдущей корзины и средним следующей. Для выбора нужна следующая
+     * корзина, поэтому в памяти держатся только две: текущая и заполняемая.
+     * Кандидатов в корзине не больше CAP: при переполнении соседние пары
+     * сливаются, и каждый слот дальше представляет группу точек вдвое длиннее.
+     * Из группы остается точка, дальше всех отстоящая от среднего корзины, —
+     * пики и провалы, которые и выбирает LTTB, не теряются. Среднее считается
+     * по всем точкам.
+     */
+    template <size_t CAP>
+    class LttbSampler
+    {
+    private:
+        struct Bucket
+        {
+            int32_t t[CAP];
+            int32_t v[CAP];
+            uint16_t count;
+            uint16_t stride;
+            uint32_t seen;
+            int64_t sumT, sumV;
+            int32_t index;
+
+            void reset(int32_t i)
+            {
+                count = 0;
+                stride = 1;
+                seen = 0;
+                sumT = sumV = 0;
+                index = i;
+            }
+
+            int64_t deviation(int32_t value) const
+            {
+                int64_t d = (int64_t)value * seen - sumV;
+                return d < 0 ? -d : d;
+            }
+
+            // Точка той же группы, что и последний слот: остается более удаленная от среднего
+            void merge(int32_t time, int32_t value)
+            {
+                if (deviation(value) > deviation(v[count - 1]))
+                {
+                    t[count - 1] = time;
+                    v[count - 1] = value;
+                }
+            }
+
+            void add(int32_t time, int32_t value)
+            {
+                sumT += time;
+                sumV += value;
+                if (seen++ % stride)
+                {
+                    merge(time, value);
+                    return;
+                }
+                if (count == CAP)
+                {
+                    for (uint16_t i = 0; i < CAP / 2; i++)
+                    {
+                        uint16_t k = deviation(v[2 * i + 1]) > deviation(v[2 * i]) ? 2 * i + 1 : 2 * i;
+                        t[i] = t[k];
+                        v[i] = v[k];
+                    }
+                    count = CAP / 2;
+                    stride *= 2;
+                    if ((seen - 1) % stride)
+                    {
+                        merge(time, value);
+                        return;
+                    }
+                }
+                t[count] = time;
+                v[count] = value;
+                count++;
+            }
+        };
+
+        Bucket _buckets[2];
+        Bucket *_cur = &_buckets[0];  // Корзина, из которой выбираем
+        Bucket *_next = &_buckets[1]; // Заполняемая следующая
+
+        PointSink _sink = nullptr;
+        void *_context = nullptr;
+        uint32_t _total = 1;    // Записей между первой и последней
+        uint32_t _interior = 0; // Корзин (0 — только первая и последняя точки)
+        uint32_t _seen = 0;
+        bool _started = false;
+        int32_t _aT = 0, _aV = 0;     // Последняя выбранная точка
+        int32_t _lastT = 0, _lastV = 0;
+        uint32_t _emitted = 0;
+
+        void emit(int32_t t, int32_t v)
+        {
+            _aT = t;
+            _aV = v;
+            _emitted++;
+            _sink(t, v, _context);
+        }
+
+        /**
+         * Выбор точки в _cur относительно средней точки (cT, cV)
+         */
+        void select(int64_t cT, int64_t cV)
+        {
+            if (_cur->count == 0)
+                return;
+            uint16_t best = 0;
+            int64_t bestArea = -1;
+            for (uint16_t i = 0; i < _cur->count; i++)
+            {
+                int64_t area = (int64_t)(_aT - cT) * (_cur->v[i] - _aV) - (int64_t)(_aT - _cur->t[i]) * (cV - _aV);
+                if (area < 0)
+                    area = -area;
+                if (area > bestArea)
+                {
+                    bestArea = area;
+                    best = i;
+                }
+            }
+            emit(_cur->t[best], _cur->v[best]);
+        }
+
+        void advance()
+        {
+            Bucket *done = _cur;
+            _cur = _next;
+            _next = done;
+            _next->reset(_cur->index + 1);
+        }
+
+    public:
+        /**
+         * total — сколько записей будет подано в add(), points — сколько точек
+         * выдать (включая первую и последнюю)
+         */
+        void begin(uint32_t total, uint32_t points, PointSink sink, void *context)
+        {
+            _total = total > 2 ? total - 2 : 1;
+            _interior = points > 2 ? points - 2 : 0;
+            _sink = sink;
+            _context = context;
+            _started = false;
+            _seen = 0;
+            _emitted = 0;
+            _cur->reset(0);
+            _next->reset(1);
+        }
+
+        void add(int32_t t, int32_t v)
+        {
+            if (!_started)
+            {
+                _started = true;
+                emit(t, v);
+                _lastT = t;
+                _lastV = v;
+                return;
+            }
+            _lastT = t;
+            _lastV = v;
+            if (_interior == 0)
+                return;
+            // Последняя запись (и все сверх total) в корзины не входит: она выдается в finish()
+            int32_t index = (int32_t)((uint64_t)_seen++ * _interior / _total);
+            if (index >= (int32_t)_interior)
+                return;
+
+            // Корзина _next закрыта: выбираем в _cur по ее среднему
+            while (index > _next->index)
+            {
+                if (_next->seen > 0)
+                    select(_next->sumT / _next->seen, _next->sumV / _next->seen);
+                else if (_cur->count > 0)
+                {
+                    // Пустая следующая корзина: опора — текущая точка
+                    select(t, v);
+                }
+                advance();
+            }
+            if (index <= _cur->index)
+                _cur->add(t, v);
+            else
+                _next->add(t, v);
+        }
+
+        /**
+         * Дожимает две оставшиеся корзины и выдает последнюю точку
+         */
+        void finish()
+        {
+            if (!_started)
+                return;
+            if (_interior == 0)
+            {
+                if (_aT != _lastT)
+                    emit(_lastT, _lastV);
+                return;
+            }
+            if (_next->seen > 0)
+                select(_next->sumT / _next->seen, _next->sumV / _next->seen);
+            else
+                select(_lastT, _lastV);
+            advance();
+            select(_lastT, _lastV);
+            if (_aT != _lastT)
+                emit(_lastT, _lastV);
+        }
+
+        uint32_t emitted() const { return _emitted; }
+    };
+}
+
+#endif
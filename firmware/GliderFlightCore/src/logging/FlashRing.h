@@ -0,0 +1,328 @@
+#ifndef FLASH_RING_H
+#define FLASH_RING_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <LittleFS.h>
+#include "LogSink.h"
+#include "../config/Config.h"
+#include "../core/Storage.h"
+#include "../utils/Crc32.h"
+
+extern "C" uint32_t _FS_start;
+
+namespace Logging
+{
+    /**
+     * Заголовок слота кольца. Стертая флеш читается как 0xFF, поэтому
+     * seq == 0xFFFFFFFF означает пустой слот.
+     */
+    struct __attribute__((packed)) RingSlotHeader
+    {
+        uint32_t seq;       // Сквозной номер слота
+        uint32_t flightId;
+        uint16_t pageIndex; // Номер страницы в логе полета (0 — заголовок лога)
+        uint16_t length;    // Полезных байт в странице
+        uint32_t crc;       // CRC-32 полей выше и полезных данных
+    };
+
+    const uint32_t RING_SECTOR_SIZE = 4096;
+    const uint32_t RING_SLOT_SIZE = sizeof(RingSlotHeader) + LOG_PAGE_SIZE;
+    const uint32_t RING_SLOTS_PER_SECTOR = RING_SECTOR_SIZE / RING_SLOT_SIZE;
+    const uint32_t RING_EMPTY = 0xFFFFFFFF;
+
+    static_assert(RING_SLOT_SIZE % 4 == 0, "Flash access must be 4-byte aligned");
+
+    /**
+     * Журнал полета в сыром флеше мимо LittleFS.
+     *
+     * Область FLASH_RING_SECTORS секторов сразу под LittleFS (конец места под
+     * OTA-образ, OTA в прошивке не используется). Сектор делится на слоты
+     * фиксированного размера: заголовок с CRC + страница лога. Слоты пишутся
+     * строго по порядку, сектор стирается целиком перед первой записью.
+     *
+     * В полете запись — только программирование одного слота (~1 мс): сектора
+     * стираются заранее в ARMED (prepare), по одному за проход loop().
+     * Стирание в полете (кончились подготовленные сектора) считается в
+     * late_erases. На земле лог полета экспортируется в log_N.dat, так что
+     * веб-интерфейс и декодер работают с обычными файлами.
+     *
+     * После сброса питания голова кольца находится по первым слотам секторов
+     * (FLASH_RING_SECTORS чтений по 16 байт) и бинарному поиску внутри
+     * последнего сектора; неэкспортированный полет выгружается в begin().
+     */
+    class FlashRingSink : public LogSink
+    {
+    private:
+        uint32_t _base = 0; // Физический адрес начала области
+        uint32_t _totalSlots = 0;
+        bool _available = false;
+
+        uint32_t _head = 0;     // Следующий слот для записи (линейный номер)
+        uint32_t _nextSeq = 1;
+        uint16_t _erased = 0;   // Подряд стертых секторов, начиная с сектора головы
+
+        uint32_t _flightId = 0;
+        uint16_t _pageIndex = 0;
+        uint32_t _flightStart = 0;
+
+        uint32_t _slot[RING_SLOT_SIZE / 4];
+
+        // Статистика
+        uint32_t _maxWriteUs = 0;
+        uint32_t _maxEraseUs = 0;
+        uint32_t _lateErases = 0;
+        uint32_t _crcErrors = 0;
+        uint32_t _recovered = 0;
+
+        uint32_t slotAddress(uint32_t slot) const
+        {
+            return _base + (slot / RING_SLOTS_PER_SECTOR) * RING_SECTOR_SIZE +
+                   (slot % RING_SLOTS_PER_SECTOR) * RING_SLOT_SIZE;
+        }
+
+        uint16_t sectorOf(uint32_t slot) const { return slot / RING_SLOTS_PER_SECTOR; }
+
+        RingSlotHeader *header() { return (RingSlotHeader *)_slot; }
+        uint8_t *payload() { return (uint8_t *)_slot + sizeof(RingSlotHeader); }
+
+        uint32_t slotSeq(uint32_t slot)
+        {
+            uint32_t seq = RING_EMPTY;
+            ESP.flashRead(slotAddress(slot), &seq, sizeof(seq));
+            return seq;
+        }
+
+        uint32_t slotCrc()
+        {
+            uint32_t crc = Utils::crc32(_slot, offsetof(RingSlotHeader, crc));
+            return Utils::crc32(payload(), header()->length, crc);
+        }
+
+        /**
+         * Читает слот в _slot; false, если он пуст или поврежден
+         */
+        bool readSlot(uint32_t slot)
+        {
+            if (!ESP.flashRead(slotAddress(slot), _slot, RING_SLOT_SIZE))
+                return false;
+            if (header()->seq == RING_EMPTY)
+                return false;
+            if (header()->length > LOG_PAGE_SIZE || slotCrc() != header()->crc)
+            {
+                _crcErrors++;
+                return false;
+            }
+            return true;
+        }
+
+        /**
+         * Стирает сектор, если он не чистый (проверка чтением в ~10 раз быстрее стирания)
+         */
+        void eraseSector(uint16_t sector)
+        {
+            uint32_t start = micros();
+            uint32_t address = _base + sector * RING_SECTOR_SIZE;
+            bool clean = true;
+            for (uint32_t offset = 0; clean && offset < RING_SECTOR_SIZE; offset += RING_SLOT_SIZE)
+            {
+                size_t chunk = min(RING_SLOT_SIZE, RING_SECTOR_SIZE - offset);
+                ESP.flashRead(address + offset, _slot, chunk);
+                for (size_t i = 0; i < chunk / 4; i++)
+                    clean = clean && _slot[i] == RING_EMPTY;
+            }
+            if (!clean)
+                ESP.flashEraseSector(address / RING_SECTOR_SIZE);
+            _maxEraseUs = max(_maxEraseUs, (uint32_t)(micros() - start));
+        }
+
+        /**
+         * Поиск головы кольца после включения
+         */
+        void scan()
+        {
+            uint16_t sectors = _totalSlots / RING_SLOTS_PER_SECTOR;
+            int32_t lastSector = -1;
+            uint32_t lastSeq = 0;
+            for (uint16_t s = 0; s < sectors; s++)
+            {
+                uint32_t seq = slotSeq(s * RING_SLOTS_PER_SECTOR);
+                if (seq != RING_EMPTY && (lastSector < 0 || seq > lastSeq))
+                {
+                    lastSector = s;
+                    lastSeq = seq;
+                }
+            }
+            if (lastSector < 0)
+            {
+                _head = 0;
+                _nextSeq = 1;
+                _erased = 0;
+                return;
+            }
+
+            // Первый пустой слот в секторе: слоты заполняются по порядку
+            uint32_t first = lastSector * RING_SLOTS_PER_SECTOR;
+            uint32_t lo = 1, hi = RING_SLOTS_PER_SECTOR;
+            while (lo < hi)
+            {
+                uint32_t mid = (lo + hi) / 2;
+                if (slotSeq(first + mid) == RING_EMPTY)
+                    hi = mid;
+                else
+                    lo = mid + 1;
+            }
+            _nextSeq = slotSeq(first + lo - 1) + 1;
+            _head = (first + lo) % _totalSlots;
+            // Остаток частично заполненного сектора уже стерт
+            _erased = lo < RING_SLOTS_PER_SECTOR ? 1 : 0;
+        }
+
+        /**
+         * Переписывает страницы полета [from, to) в log_N.dat
+         */
+        void exportFlight(uint32_t flightId, uint32_t from, uint32_t to)
+        {
+            uint32_t start = millis();
+            File file = Storage::createLog(flightId);
+            if (!file)
+                return;
+            uint32_t pages = 0;
+            for (uint32_t slot = from; slot != to; slot = (slot + 1) % _totalSlots)
+            {
+                if (!readSlot(slot) || header()->flightId != flightId)
+                    continue;
+                file.write(payload(), header()->length);
+                pages++;
+            }
+            file.close();
+            Serial.printf("[Ring] Полет %u: %u страниц экспортировано за %lu мс\n", flightId, pages, millis() - start);
+        }
+
+        /**
+         * Выгрузка полета, прерванного сбросом питания. Последний слот мог
+         * остаться недописанным, поэтому полет ищется по самому свежему
+         * целому слоту в пределах сектора головы.
+         */
+        void recover()
+        {
+            uint32_t last = (_head + _totalSlots - 1) % _totalSlots;
+            uint32_t back = 0;
+            while (!readSlot(last))
+            {
+                if (++back >= RING_SLOTS_PER_SECTOR || slotSeq(last) == RING_EMPTY)
+                    return;
+                last = (last + _totalSlots - 1) % _totalSlots;
+            }
+            uint32_t flightId = header()->flightId;
+            if (LittleFS.exists(Storage::logPath(flightId)))
+                return;
+            uint32_t from = (last + _totalSlots - header()->pageIndex) % _totalSlots;
+            Serial.printf("[Ring] Восстановление полета %u после сброса\n", flightId);
+            exportFlight(flightId, from, _head);
+            _recovered++;
+        }
+
+    public:
+        const char *name() const override { return "flash_ring"; }
+
+        /**
+         * Размещение области, поиск головы и восстановление. Вызывается в setup().
+         */
+        bool begin()
+        {
+            // Физический адрес LittleFS (как FS_PHYS_ADDR в FlashMap.h ядра)
+            uint32_t fsStart = (uint32_t)(uintptr_t)&_FS_start - 0x40200000;
+            uint32_t size = FLASH_RING_SECTORS * RING_SECTOR_SIZE;
+            uint32_t sketchEnd = (ESP.getSketchSize() + 0x1000 + RING_SECTOR_SIZE - 1) & ~(RING_SECTOR_SIZE - 1);
+            if (fsStart < size || fsStart - size < sketchEnd)
+            {
+                Serial.println("[Ring] Нет места под кольцо лога, запись через LittleFS");
+                return _available = false;
+            }
+            _base = fsStart - size;
+            _totalSlots = FLASH_RING_SECTORS * RING_SLOTS_PER_SECTOR;
+            _available = true;
+
+            scan();
+            recover();
+            Serial.printf("[Ring] 0x%06X, %u слотов, голова %u, seq %u\n", _base, _totalSlots, _head, _nextSeq);
+            return true;
+        }
+
+        bool available() const { return _available; }
+
+        bool open(uint32_t flightId) override
+        {
+            if (!_available)
+                return false;
+            _flightId = flightId;
+            _pageIndex = 0;
+            _flightStart = _head;
+            _maxWriteUs = 0;
+            _lateErases = 0;
+            return true;
+        }
+
+        bool write(const uint8_t *page, size_t length) override
+        {
+            Diagnostics::PerfScope perf(Diagnostics::PERF_FS_WRITE);
+            // Не заходим на начало собственного полета
+            if (_pageIndex >= _totalSlots - RING_SLOTS_PER_SECTOR)
+                return false;
+            uint32_t start = micros();
+            if (_erased == 0)
+            {
+                // Подготовленные сектора кончились — стирание в полете
+                eraseSector(sectorOf(_head));
+                _erased = 1;
+                _lateErases++;
+            }
+
+            header()->seq = _nextSeq++;
+            header()->flightId = _flightId;
+            header()->pageIndex = _pageIndex++;
+            header()->length = length;
+            memcpy(payload(), page, length);
+            memset(payload() + length, 0xFF, LOG_PAGE_SIZE - length);
+            header()->crc = slotCrc();
+            bool ok = ESP.flashWrite(slotAddress(_head), _slot, RING_SLOT_SIZE);
+
+            _head = (_head + 1) % _totalSlots;
+            if (_head % RING_SLOTS_PER_SECTOR == 0)
+                _erased--;
+            _maxWriteUs = max(_maxWriteUs, (uint32_t)(micros() - start));
+            return ok;
+        }
+
+        void close() override { exportFlight(_flightId, _flightStart, _head); }
+
+        /**
+         * Стирает не больше одного сектора впереди головы за вызов
+         */
+        void prepare() override
+        {
+            uint16_t sectors = _totalSlots / RING_SLOTS_PER_SECTOR;
+            if (!_available || _erased >= FLASH_RING_PREERASE || _erased >= sectors - 1)
+                return;
+            eraseSector((sectorOf(_head) + _erased) % sectors);
+            _erased++;
+        }
+
+        void serialize(JsonObject &doc) const
+        {
+            doc["available"] = _available;
+            doc["head"] = _head;
+            doc["erased_ahead"] = _erased;
+            doc["max_write_us"] = _maxWriteUs;
+            doc["max_erase_us"] = _maxEraseUs;
+            doc["late_erases"] = _lateErases;
+            doc["crc_errors"] = _crcErrors;
+            doc["recovered"] = _recovered;
+        }
+    };
+
+    FlashRingSink flashRing;
+}
+
+#endif
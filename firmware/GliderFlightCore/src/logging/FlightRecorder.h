@@ -0,0 +1,416 @@
+#ifndef FLIGHT_RECORDER_H
+#define FLIGHT_RECORDER_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "LogFormat.h"
+#include "LogCodec.h"
+#include "LogSink.h"
+#include "FlashRing.h"
+#include "RecordRing.h"
+#include "LogSeek.h"
+#include "LogIndex.h"
+#include "LogRecovery.h"
+#include "FlightStats.h"
+#include "../config/Config.h"
+#include "../core/Storage.h"
+#include "../core/Sensors.h"
+
+namespace Logging
+{
+    /**
+     * Бортовой самописец: пишет лог полета в режиме FLIGHT.
+     *
+     * Каждый расчет высоты (Sensors::telemetry) превращается в LogRecord и
+     * дельта-кодируется (LogCodec.h) в RAM-страницу. Заполненная страница уходит
+     * в хранилище (LogSink) целиком, не больше одной страницы за вызов service().
+     * Две страницы в RAM дают запас, пока предыдущая пишется.
+     *
+     * В ARMED расчеты высоты идут с PRETRIGGER_RATE_HZ в кольцо предзаписи;
+     * при старте его содержимое становится началом лога (время < 0), а само
+     * кольцо дальше служит очередью перед кодером.
+     *
+     * Частота записи в полете идет по LOG_RATE_SCHEDULE (время от старта) и
+     * поднимается до LOG_BOOST_RATE_HZ при заметной вертикальной скорости.
+     * Каждая запись несет действующую частоту, кодер отмечает ее смену.
+     *
+     * Страницы лога — журналируемые блоки (LogBlock.h): номер, метка фиксации
+     * и CRC-32 в концевике. Недописанный при сбросе питания хвост отрезается
+     * при загрузке (LogRecovery.h).
+     *
+     * В конце лога пишется таблица поиска по времени, сводка полета
+     * дописывается в индекс /logs.idx (LogIndex.h).
+     * С LOG_FLASH_RING страницы пишутся в сырое флеш-кольцо (FlashRing.h),
+     * иначе — прямо в log_N.dat на LittleFS.
+     */
+    class FlightRecorder
+    {
+    private:
+        static const uint8_t PAGE_COUNT = 2;
+
+        uint8_t _pages[PAGE_COUNT][LOG_PAGE_SIZE];
+        bool _pageFull[PAGE_COUNT];
+        PageEncoder _encoder;
+        bool _encoderOpen = false;
+        uint8_t _fillPage = 0;
+        uint8_t _flushPage = 0;
+
+        RecordRing<PRETRIGGER_DEPTH> _ring;
+        SeekTable _seek;
+        FlightStats _stats;
+
+        LogSink *_sink = &fsSink;
+        bool _active = false;
+        bool _armed = false;
+        bool _prevMonitoring = false;
+        uint32_t _flightId = 0;
+        unsigned long _startMillis = 0;
+        uint16_t _rateHz = 0;
+        unsigned long _boostUntil = 0;
+        uint32_t _lastSeq = 0;
+        uint16_t _blockSeq = 0;
+
+        // Статистика текущего/последнего полета
+        uint32_t _records = 0;
+        uint32_t _dropped = 0;
+        uint32_t _pagesWritten = 0;
+        uint32_t _maxWriteUs = 0;
+        uint32_t _rateChanges = 0;
+        int32_t _firstTimeMs = 0;
+        int32_t _lastTimeMs = 0;
+
+        bool writeHeader()
+        {
+            uint8_t page[LOG_PAGE_SIZE] = {0};
+            LogHeader header;
+            header.magic = LOG_MAGIC;
+            header.version = LOG_VERSION;
+            header.recordSize = sizeof(LogRecord);
+            header.flightId = _flightId;
+            header.startMillis = _startMillis;
+            header.basePressureMilliPa = Sensors::calData.adaptiveBaseline;
+            header.rateHz = _rateHz;
+            header.encoding = LOG_ENCODING_DELTA;
+            memcpy(page, &header, sizeof(header));
+            sealBlock(page, 0);
+            _blockSeq = 1;
+            return _sink->write(page, sizeof(page));
+        }
+
+        /**
+         * Запись по свежему расчету высоты; время пока абсолютное (millis)
+         */
+        LogRecord captureRecord() const
+        {
+            const Sensors::TelemetryData &t = Sensors::telemetry;
+            LogRecord rec;
+            rec.timeMs = (int32_t)t.timestamp;
+            rec.pressurePa = t.pressure;
+            rec.altitudeCm = (int32_t)lroundf(t.altitude * 100);
+            rec.temperatureCenti = (int16_t)lroundf(Sensors::readTemperature() * 100);
+            rec.flags = (Sensors::sys.calibrated ? REC_CALIBRATED : 0) | (t.isStable ? REC_STABLE : 0);
+            rec.rateHz = _rateHz;
+            return rec;
+        }
+
+        void writePage(uint8_t index, size_t bytes)
+        {
+            uint32_t start = micros();
+            sealBlock(_pages[index], _blockSeq++);
+            if (!_sink->write(_pages[index], bytes))
+                Serial.println("[Recorder] Ошибка записи страницы лога");
+            _pagesWritten++;
+            _maxWriteUs = max(_maxWriteUs, (uint32_t)(micros() - start));
+        }
+
+        bool captureNew()
+        {
+            if (Sensors::telemetry.seq == _lastSeq)
+                return false;
+            _lastSeq = Sensors::telemetry.seq;
+            return true;
+        }
+
+        /**
+         * Переносит записи из кольца в кодер, пока есть место в RAM-страницах
+         */
+        void drainRing()
+        {
+            LogRecord rec;
+            while (_ring.peek(rec))
+            {
+                rec.timeMs = (int32_t)((uint32_t)rec.timeMs - _startMillis);
+                if (!append(rec))
+                    return;
+                _ring.pop();
+            }
+        }
+
+        void flushPage()
+        {
+            writePage(_flushPage, LOG_PAGE_SIZE);
+            _pageFull[_flushPage] = false;
+            _flushPage = (_flushPage + 1) % PAGE_COUNT;
+        }
+
+        void applyRate(uint16_t hz)
+        {
+            if (hz == _rateHz)
+                return;
+            _rateHz = hz;
+            _rateChanges++;
+            Sensors::setOutputInterval(1000 / hz);
+        }
+
+        void monitorAt(uint16_t hz)
+        {
+            if (!_armed)
+            {
+                _prevMonitoring = Sensors::sys.monitoring;
+                _armed = true;
+            }
+            Sensors::sys.monitoring = true;
+            applyRate(hz);
+        }
+
+        /**
+         * Частота записи для момента flightMs от старта
+         */
+        uint16_t scheduledRate(unsigned long now, uint32_t flightMs)
+        {
+            uint16_t hz = 1;
+            for (const LogRateStep &step : LOG_RATE_SCHEDULE)
+            {
+                hz = step.rateHz;
+                if (flightMs < step.untilMs)
+                    break;
+            }
+            if (LOG_BOOST_RATE_HZ > 0)
+            {
+                if (fabsf(Sensors::telemetry.verticalSpeed) > LOG_BOOST_VSPEED)
+                    _boostUntil = now + LOG_BOOST_HOLD_MS;
+                if ((long)(_boostUntil - now) > 0)
+                    hz = max(hz, LOG_BOOST_RATE_HZ);
+            }
+            return constrain(hz, 1, LOG_MAX_RATE_HZ);
+        }
+
+        LogSink *selectSink()
+        {
+#ifdef LOG_FLASH_RING
+            if (flashRing.available())
+                return &flashRing;
+#endif
+            return &fsSink;
+        }
+
+    public:
+        /**
+         * Инициализация хранилища: восстановление кольца и недописанного
+         * лога после сброса, затем индекс. Вызывается в setup().
+         */
+        void begin()
+        {
+#ifdef LOG_FLASH_RING
+            flashRing.begin();
+#endif
+            // Восстановление ищет лог в индексе: индекс старого формата убирается раньше
+            checkIndex();
+            recoverLog();
+            syncIndex();
+        }
+
+        /**
+         * Вход в ARMED: частые расчеты высоты и пустое кольцо предзаписи
+         */
+        void arm()
+        {
+            monitorAt(PRETRIGGER_RATE_HZ);
+            _ring.reset();
+            _lastSeq = Sensors::telemetry.seq;
+        }
+
+        /**
+         * Выход из ARMED на землю: мониторинг возвращается в прежнее состояние
+         */
+        void disarm()
+        {
+            if (!_armed)
+                return;
+            _armed = false;
+            _ring.reset();
+            Sensors::sys.monitoring = _prevMonitoring;
+            Sensors::setOutputInterval(BARO_INTERVAL);
+            _rateHz = 0;
+        }
+
+        /**
+         * Вызывается из loop() в ARMED: предзапись и подготовка хранилища
+         */
+        void serviceArmed()
+        {
+            if (_active)
+                return;
+            if (_armed && captureNew())
+                _ring.push(captureRecord(), true);
+            selectSink()->prepare();
+        }
+
+        /**
+         * Открывает новый лог. now — момент старта (t = 0); накопленная
+         * предзапись становится началом лога.
+         */
+        bool start(unsigned long now)
+        {
+            if (_active)
+                return true;
+            _flightId = Storage::findNextLogId();
+            _sink = selectSink();
+            if (!_sink->open(_flightId))
+                return false;
+
+            _startMillis = now;
+            _fillPage = _flushPage = 0;
+            _encoderOpen = false;
+            for (uint8_t i = 0; i < PAGE_COUNT; i++)
+                _pageFull[i] = false;
+            _records = _dropped = _pagesWritten = _maxWriteUs = _rateChanges = 0;
+            _firstTimeMs = _lastTimeMs = 0;
+            _seek.reset();
+            _stats.reset();
+            _boostUntil = now;
+
+            // В полете высота считается с частотой записи
+            monitorAt(scheduledRate(now, 0));
+
+            _active = writeHeader();
+            Serial.printf("[Recorder] Запись полета %u, %u Гц (%s)\n", _flightId, _rateHz, _sink->name());
+            return _active;
+        }
+
+        /**
+         * Постановка записи в RAM-страницу; false, если обе страницы ждут записи во флеш
+         */
+        bool append(const LogRecord &rec)
+        {
+            if (!_encoderOpen)
+            {
+                if (_pageFull[_fillPage])
+                    return false;
+                _encoder.begin(_pages[_fillPage]);
+                _encoderOpen = true;
+                _seek.addPage(rec.timeMs);
+            }
+            if (_encoder.add(rec))
+            {
+                if (_records++ == 0)
+                    _firstTimeMs = rec.timeMs;
+                _lastTimeMs = rec.timeMs;
+                return true;
+            }
+            // Страница заполнена: закрываем ее, запись станет ключевым кадром следующей
+            _encoder.finish();
+            _pageFull[_fillPage] = true;
+            _fillPage = (_fillPage + 1) % PAGE_COUNT;
+            _encoderOpen = false;
+            return append(rec);
+        }
+
+        /**
+         * Вызывается из loop(): забирает свежий расчет высоты и пишет
+         * не более одной готовой страницы.
+         */
+        void service(unsigned long now)
+        {
+            if (!_active)
+                return;
+            if (captureNew())
+            {
+                LogRecord rec = captureRecord();
+                if (!_ring.push(rec, false))
+                    _dropped++;
+                // Сводка считается по каждому расчету, даже если запись потеряна
+                _stats.add((int32_t)(Sensors::telemetry.timestamp - _startMillis), rec.altitudeCm,
+                           (int32_t)lroundf(Sensors::telemetry.verticalSpeed * 100));
+            }
+            applyRate(scheduledRate(now, now - _startMillis));
+            drainRing();
+            if (_pageFull[_flushPage])
+                flushPage();
+        }
+
+        /**
+         * Дописывает все, что осталось в RAM, и закрывает файл
+         */
+        void stop()
+        {
+            if (!_active)
+                return;
+            drainRing();
+            while (_pageFull[_flushPage])
+            {
+                flushPage();
+                drainRing();
+            }
+            if (_encoderOpen && !_encoder.empty())
+            {
+                _encoder.finish();
+                writePage(_fillPage, LOG_PAGE_SIZE);
+            }
+
+            // Таблица поиска с новой страницы; обе RAM-страницы уже свободны
+            uint32_t seekOffset = (1 + _seek.pages()) * LOG_PAGE_SIZE;
+            uint8_t *tail = &_pages[0][0];
+            static_assert(sizeof(LogSeekHeader) + LOG_SEEK_MAX * sizeof(int32_t) <= sizeof(_pages), "Seek table must fit into RAM pages");
+            memset(tail, 0xFF, sizeof(_pages));
+            _seek.serialize(tail);
+            size_t tailPages = (_seek.size() + LOG_PAGE_SIZE - 1) / LOG_PAGE_SIZE;
+            for (size_t i = 0; i < tailPages; i++)
+                _sink->write(tail + i * LOG_PAGE_SIZE, LOG_PAGE_SIZE);
+
+            _sink->close();
+            _active = false;
+            _ring.reset();
+
+            LogIndexEntry entry = {};
+            entry.flightId = _flightId;
+            entry.startMillis = _startMillis;
+            entry.firstTimeMs = _firstTimeMs;
+            entry.lastTimeMs = _lastTimeMs;
+            entry.records = _records;
+            entry.seekOffset = seekOffset;
+            entry.fileSize = seekOffset + tailPages * LOG_PAGE_SIZE;
+            applyStats(entry, _stats);
+            if (!appendIndex(entry))
+                Serial.println("[Recorder] Ошибка записи индекса логов");
+            Serial.printf("[Recorder] Полет %u записан: %u записей, потеряно %u, смен частоты %u, макс. запись страницы %u мкс\n",
+                          _flightId, _records, _dropped, _rateChanges, _maxWriteUs);
+        }
+
+        bool isActive() const { return _active; }
+        uint32_t flightId() const { return _flightId; }
+
+        void serialize(JsonObject &doc) const
+        {
+            doc["active"] = _active;
+            doc["backend"] = _sink->name();
+            doc["flight"] = _flightId;
+            doc["records"] = _records;
+            doc["dropped"] = _dropped;
+            doc["rate_hz"] = _rateHz;
+            doc["rate_changes"] = _rateChanges;
+            doc["max_write_us"] = _maxWriteUs;
+            doc["max_alt"] = _stats.maxAltitudeCm / 100.0f;
+#ifdef LOG_FLASH_RING
+            JsonObject ring = doc.createNestedObject("ring");
+            flashRing.serialize(ring);
+#endif
+            JsonObject journal = doc.createNestedObject("recovery");
+            recovery.serialize(journal);
+        }
+    };
+
+    FlightRecorder recorder;
+}
+
+#endif
@@ -0,0 +1,120 @@
+#ifndef FLIGHT_STATS_H
+#define FLIGHT_STATS_H
+
+#include <stdint.h>
+
+namespace Logging
+{
+    // Набор высоты считается законченным, когда скорость падает ниже порога
+    const int32_t STATS_CLIMB_END_VSPEED_CMS = 50;
+    const int32_t STATS_CLIMB_MIN_MS = 1000; // Раньше этого конец набора не ищется
+
+    /**
+     * Вертикальная скорость по высотам из лога — для перестройки сводки без
+     * скорости фильтра (scanLog): разность высот за окно не короче
+     * STATS_VSPEED_WINDOW_MS. Разность соседних записей на 25 Гц дает порог
+     * конца набора (50 см/с) уже на шаге в 2 см, и конец набора находился
+     * бы по шуму, а не так, как по скорости фильтра в полете.
+     */
+    const int32_t STATS_VSPEED_WINDOW_MS = STATS_CLIMB_MIN_MS;
+
+    class VspeedWindow
+    {
+    private:
+        static const uint8_t SIZE = 32; // Окно 1 с при частоте записи до 31 Гц
+        int32_t _t[SIZE];
+        int32_t _alt[SIZE];
+        uint8_t _first = 0;
+        uint8_t _count = 0;
+
+        uint8_t at(uint8_t i) const { return (_first + i) % SIZE; }
+
+    public:
+        void reset() { _first = _count = 0; }
+
+        /**
+         * Добавляет запись и возвращает скорость за окно, см/с
+         */
+        int32_t add(int32_t timeMs, int32_t altitudeCm)
+        {
+            if (_count == SIZE)
+            {
+                _first = at(1);
+                _count--;
+            }
+            _t[at(_count)] = timeMs;
+            _alt[at(_count)] = altitudeCm;
+            _count++;
+            // Старейшая точка уходит, если и без нее окно не короче заданного
+            while (_count > 2 && timeMs - _t[at(1)] >= STATS_VSPEED_WINDOW_MS)
+            {
+                _first = at(1);
+                _count--;
+            }
+            int32_t dt = timeMs - _t[_first];
+            if (_count < 2 || dt <= 0)
+                return 0;
+            return (int32_t)((int64_t)(altitudeCm - _alt[_first]) * 1000 / dt);
+        }
+    };
+
+    /**
+     * Сводка полета, накапливаемая по ходу записи: O(1) состояния на метрику,
+     * ничего не хранит и не перечитывает. Учитываются только точки с t >= 0
+     * (предзапись в ARMED — не полет).
+     */
+    struct FlightStats
+    {
+        int32_t maxAltitudeCm;
+        int32_t timeOfMaxMs;
+        int32_t launchHeightCm; // Высота в конце набора (старт)
+        int32_t launchEndMs;
+        int32_t lastAltitudeCm;
+        int32_t lastTimeMs;
+        bool climbing;
+        bool started;
+
+        void reset()
+        {
+            maxAltitudeCm = timeOfMaxMs = 0;
+            launchHeightCm = launchEndMs = 0;
+            lastAltitudeCm = lastTimeMs = 0;
+            climbing = true;
+            started = false;
+        }
+
+        void add(int32_t timeMs, int32_t altitudeCm, int32_t vspeedCmS)
+        {
+            if (timeMs < 0)
+                return;
+            if (!started || altitudeCm > maxAltitudeCm)
+            {
+                maxAltitudeCm = altitudeCm;
+                timeOfMaxMs = timeMs;
+            }
+            started = true;
+            if (climbing)
+            {
+                launchHeightCm = maxAltitudeCm;
+                launchEndMs = timeOfMaxMs;
+                if (timeMs >= STATS_CLIMB_MIN_MS && vspeedCmS < STATS_CLIMB_END_VSPEED_CMS)
+                    climbing = false;
+            }
+            lastAltitudeCm = altitudeCm;
+            lastTimeMs = timeMs;
+        }
+
+        /**
+         * Средняя скорость снижения в планировании (от конца набора), см/с
+         */
+        int32_t sinkRateCmS() const
+        {
+            int32_t glideMs = lastTimeMs - launchEndMs;
+            if (climbing || glideMs <= 0)
+                return 0;
+            return (int32_t)((int64_t)(launchHeightCm - lastAltitudeCm) * 1000 / glideMs);
+        }
+    };
+}
+
+#endif
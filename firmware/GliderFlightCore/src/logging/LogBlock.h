@@ -0,0 +1,79 @@
+#ifndef LOG_BLOCK_H
+#define LOG_BLOCK_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "LogFormat.h"
+#include "../utils/Crc32.h"
+
+/**
+ * Журналируемые блоки лога (с версии 4): каждая страница — блок с концевиком
+ * в последних байтах. Концевик несет номер блока, метку фиксации и CRC-32,
+ * поэтому после сброса питания полный блок отличается от недописанного без
+ * чтения остального файла.
+ */
+namespace Logging
+{
+    const uint8_t LOG_BLOCK_COMMIT = 0xA5;
+
+    struct __attribute__((packed)) LogBlockFooter
+    {
+        uint16_t seq;    // Номер страницы в файле (0 — заголовок)
+        uint8_t commit;  // LOG_BLOCK_COMMIT
+        uint8_t reserved;
+        uint32_t crc;    // CRC-32 данных блока и полей выше
+    };
+
+    const size_t LOG_PAGE_PAYLOAD = LOG_PAGE_SIZE - sizeof(LogBlockFooter);
+
+    inline uint32_t blockCrc(const uint8_t *page)
+    {
+        return Utils::crc32(page, LOG_PAGE_SIZE - sizeof(uint32_t));
+    }
+
+    /**
+     * Дописывает концевик в страницу перед записью
+     */
+    inline void sealBlock(uint8_t *page, uint16_t seq)
+    {
+        LogBlockFooter footer = {seq, LOG_BLOCK_COMMIT, 0, 0};
+        memcpy(page + LOG_PAGE_PAYLOAD, &footer, sizeof(footer));
+        footer.crc = blockCrc(page);
+        memcpy(page + LOG_PAGE_PAYLOAD, &footer, sizeof(footer));
+    }
+
+    /**
+     * Блок целый и зафиксирован; seq — его номер из концевика
+     */
+    inline bool blockIntact(const uint8_t *page, size_t length, uint16_t &seq)
+    {
+        if (length < LOG_PAGE_SIZE)
+            return false;
+        LogBlockFooter footer;
+        memcpy(&footer, page + LOG_PAGE_PAYLOAD, sizeof(footer));
+        seq = footer.seq;
+        return footer.commit == LOG_BLOCK_COMMIT && footer.crc == blockCrc(page);
+    }
+
+    /**
+     * Блок целый, зафиксирован и стоит на своем месте
+     */
+    inline bool blockValid(const uint8_t *page, size_t length, uint16_t seq)
+    {
+        uint16_t actual;
+        return blockIntact(page, length, actual) && actual == seq;
+    }
+
+    /**
+     * Длина данных кодера в странице лога данной версии
+     */
+    inline size_t pagePayload(uint16_t version, size_t length)
+    {
+        if (version >= 4 && length > LOG_PAGE_PAYLOAD)
+            return LOG_PAGE_PAYLOAD;
+        return length;
+    }
+}
+
+#endif
@@ -0,0 +1,250 @@
+#ifndef LOG_CODEC_H
+#define LOG_CODEC_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "LogFormat.h"
+#include "LogBlock.h"
+
+/**
+ * Сжатие страниц лога (LOG_ENCODING_DELTA).
+ *
+ * Каждая страница начинается с ключевого кадра — полной LogRecord, поэтому
+ * любую страницу можно декодировать отдельно (произвольный доступ по смещению
+ * 256 * k). Дальше идут дельта-записи:
+ *
+ *   ctrl      1 байт, биты CTRL_*
+ *   dt        varint, мс от предыдущей записи (нет при CTRL_DT_REPEAT)
+ *   dp        zigzag varint, Па от предыдущей записи
+ *   ddalt     zigzag varint, см: изменение приращения высоты (высота после
+ *             фильтра гладкая, поэтому вторая разность почти всегда 0..±2)
+ *   dtemp     zigzag varint, 0.01 °C (только при CTRL_TEMP)
+ *   flags     1 байт (только при CTRL_FLAGS)
+ *   rate      1 байт, новая частота записи, Гц (только при CTRL_RATE) —
+ *             маркер смены частоты; ключевой кадр несет текущую частоту сам
+ *
+ * Байт 0xFF на месте ctrl — конец данных страницы (остаток заполнен 0xFF).
+ * Данные занимают LOG_PAGE_PAYLOAD байт, в конце страницы — концевик блока.
+ * Типичная запись в полете — 3 байта против 16 у LOG_ENCODING_FIXED.
+ * Файл не зависит от Arduino и собирается в утилитах на ПК (tools/logdecode).
+ */
+namespace Logging
+{
+    enum DeltaControl : uint8_t
+    {
+        CTRL_DT_REPEAT = 0x01, // Интервал тот же, что у предыдущей записи
+        CTRL_TEMP = 0x02,      // Есть поле dtemp
+        CTRL_FLAGS = 0x04,     // Есть байт flags
+        CTRL_RATE = 0x08,      // Есть байт rate (смена частоты записи)
+        CTRL_END = 0xFF        // Конец данных страницы
+    };
+
+    const size_t DELTA_MAX_RECORD = 1 + 5 + 5 + 5 + 5 + 1 + 1;
+
+    inline uint32_t zigzagEncode(int32_t v) { return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31); }
+    inline int32_t zigzagDecode(uint32_t v) { return (int32_t)(v >> 1) ^ -(int32_t)(v & 1); }
+
+    inline size_t putVarint(uint8_t *out, uint32_t v)
+    {
+        size_t n = 0;
+        while (v >= 0x80)
+        {
+            out[n++] = (uint8_t)(v | 0x80);
+            v >>= 7;
+        }
+        out[n++] = (uint8_t)v;
+        return n;
+    }
+
+    /**
+     * Читает varint из [*pos, end); false, если данные оборваны
+     */
+    inline bool getVarint(const uint8_t *&pos, const uint8_t *end, uint32_t &v)
+    {
+        v = 0;
+        for (int shift = 0; shift < 35 && pos < end; shift += 7)
+        {
+            uint8_t b = *pos++;
+            v |= (uint32_t)(b & 0x7F) << shift;
+            if (!(b & 0x80))
+                return true;
+        }
+        return false;
+    }
+
+    /**
+     * Общее состояние предсказателя кодера и декодера
+     */
+    struct DeltaState
+    {
+        LogRecord prev;
+        int32_t dt;
+        int32_t dalt;
+
+        void reset(const LogRecord &key)
+        {
+            prev = key;
+            dt = 0;
+            dalt = 0;
+        }
+    };
+
+    /**
+     * Кодер одной страницы. add() возвращает false, если запись не помещается —
+     * тогда страница закрывается finish(), а запись открывает следующую.
+     */
+    class PageEncoder
+    {
+    private:
+        uint8_t *_page = nullptr;
+        size_t _used = 0;
+        DeltaState _state;
+
+    public:
+        void begin(uint8_t *page)
+        {
+            _page = page;
+            _used = 0;
+        }
+
+        bool add(const LogRecord &rec)
+        {
+            if (_used == 0)
+            {
+                memcpy(_page, &rec, sizeof(rec));
+                _used = sizeof(rec);
+                _state.reset(rec);
+                return true;
+            }
+
+            uint8_t buf[DELTA_MAX_RECORD];
+            size_t n = 1;
+            uint8_t ctrl = 0;
+
+            int32_t dt = rec.timeMs - _state.prev.timeMs;
+            if (dt == _state.dt)
+                ctrl |= CTRL_DT_REPEAT;
+            else
+                n += putVarint(buf + n, (uint32_t)dt);
+
+            n += putVarint(buf + n, zigzagEncode(rec.pressurePa - _state.prev.pressurePa));
+            int32_t dalt = rec.altitudeCm - _state.prev.altitudeCm;
+            n += putVarint(buf + n, zigzagEncode(dalt - _state.dalt));
+
+            if (rec.temperatureCenti != _state.prev.temperatureCenti)
+            {
+                ctrl |= CTRL_TEMP;
+                n += putVarint(buf + n, zigzagEncode(rec.temperatureCenti - _state.prev.temperatureCenti));
+            }
+            if (rec.flags != _state.prev.flags)
+            {
+                ctrl |= CTRL_FLAGS;
+                buf[n++] = rec.flags;
+            }
+            if (rec.rateHz != _state.prev.rateHz)
+            {
+                ctrl |= CTRL_RATE;
+                buf[n++] = rec.rateHz;
+            }
+            buf[0] = ctrl;
+
+            // Одна позиция резервируется под маркер конца страницы
+            if (_used + n >= LOG_PAGE_PAYLOAD)
+                return false;
+            memcpy(_page + _used, buf, n);
+            _used += n;
+            _state.prev = rec;
+            _state.dt = dt;
+            _state.dalt = dalt;
+            return true;
+        }
+
+        /**
+         * Заполняет остаток данных страницы маркером конца (концевик — sealBlock)
+         */
+        void finish()
+        {
+            memset(_page + _used, CTRL_END, LOG_PAGE_PAYLOAD - _used);
+        }
+
+        size_t used() const { return _used; }
+        bool empty() const { return _used == 0; }
+    };
+
+    /**
+     * Декодер одной страницы (len может быть меньше LOG_PAGE_SIZE в конце файла)
+     */
+    class PageDecoder
+    {
+    private:
+        const uint8_t *_pos;
+        const uint8_t *_end;
+        DeltaState _state;
+        bool _started = false;
+
+    public:
+        PageDecoder(const uint8_t *page, size_t len) : _pos(page), _end(page + len) {}
+
+        bool next(LogRecord &out)
+        {
+            if (!_started)
+            {
+                if ((size_t)(_end - _pos) < sizeof(LogRecord))
+                    return false;
+                memcpy(&out, _pos, sizeof(out));
+                _pos += sizeof(out);
+                _state.reset(out);
+                _started = true;
+                return true;
+            }
+            if (_pos >= _end || *_pos == CTRL_END)
+                return false;
+
+            uint8_t ctrl = *_pos++;
+            uint32_t v;
+            LogRecord rec = _state.prev;
+            int32_t dt = _state.dt;
+            if (!(ctrl & CTRL_DT_REPEAT))
+            {
+                if (!getVarint(_pos, _end, v))
+                    return false;
+                dt = (int32_t)v;
+            }
+            if (!getVarint(_pos, _end, v))
+                return false;
+            rec.pressurePa += zigzagDecode(v);
+            if (!getVarint(_pos, _end, v))
+                return false;
+            int32_t dalt = _state.dalt + zigzagDecode(v);
+            if (ctrl & CTRL_TEMP)
+            {
+                if (!getVarint(_pos, _end, v))
+                    return false;
+                rec.temperatureCenti += (int16_t)zigzagDecode(v);
+            }
+            if (ctrl & CTRL_FLAGS)
+            {
+                if (_pos >= _end)
+                    return false;
+                rec.flags = *_pos++;
+            }
+            if (ctrl & CTRL_RATE)
+            {
+                if (_pos >= _end)
+                    return false;
+                rec.rateHz = *_pos++;
+            }
+            rec.timeMs += dt;
+            rec.altitudeCm += dalt;
+
+            _state.prev = rec;
+            _state.dt = dt;
+            _state.dalt = dalt;
+            out = rec;
+            return true;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,120 @@
+#ifndef LOG_FORMAT_H
+#define LOG_FORMAT_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * Формат бортового лога log_N.dat.
+ * Файл не зависит от Arduino, чтобы его можно было подключить в утилитах на ПК.
+ *
+ * Раскладка файла:
+ *   [страница 0]      LogHeader, дополненный нулями до LOG_PAGE_SIZE
+ *   [страницы 1..N]   записи, по странице на LOG_PAGE_SIZE байт
+ *                     (с v4 страницы 0..N — блоки с концевиком, LogBlock.h)
+ *   [хвост]           таблица поиска LogSeekHeader + времена страниц (с v3;
+ *                     начинается с новой страницы, ее смещение хранит индекс)
+ * Кодирование страниц задает LogHeader::encoding:
+ *   LOG_ENCODING_FIXED  записи LogRecord, по LOG_RECORDS_PER_PAGE на страницу
+ *   LOG_ENCODING_DELTA  ключевой кадр + дельты в varint (см. LogCodec.h)
+ * Все многобайтовые поля little-endian (родной порядок ESP8266).
+ */
+namespace Logging
+{
+    const uint32_t LOG_MAGIC = 0x474C4647; // "GFLG"
+    const uint16_t LOG_VERSION = 4;
+    const size_t LOG_PAGE_SIZE = 256; // Страница LittleFS на ESP8266
+
+    enum LogEncoding : uint16_t
+    {
+        LOG_ENCODING_FIXED = 0,
+        LOG_ENCODING_DELTA = 1
+    };
+
+    enum RecordFlags : uint8_t
+    {
+        REC_CALIBRATED = 0x01, // Высота посчитана от действующей базы
+        REC_STABLE = 0x02      // Датчик в покое (StabilityMonitor)
+    };
+
+    struct __attribute__((packed)) LogHeader
+    {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t recordSize;
+        uint32_t flightId;
+        uint32_t startMillis;      // millis() в момент старта (t = 0)
+        int32_t basePressureMilliPa;
+        uint16_t rateHz;           // Номинальная частота записи
+        uint16_t encoding;         // LogEncoding
+    };
+
+    /**
+     * Запись фиксированного размера (16 байт)
+     */
+    struct __attribute__((packed)) LogRecord
+    {
+        int32_t timeMs;        // Время от старта, мс
+        int32_t pressurePa;    // Сырое давление, Па
+        int32_t altitudeCm;    // Высота по фильтру, см
+        int16_t temperatureCenti; // Температура, 0.01 °C
+        uint8_t flags;         // RecordFlags
+        uint8_t rateHz;        // Частота записи, действующая с этой записи (до v3 — 0)
+    };
+
+    /**
+     * Разреженная таблица "время -> страница" в конце лога: после заголовка
+     * count значений int32 — время ключевого кадра страниц 1, 1 + stride, ...
+     * Страница с данными k лежит по смещению k * LOG_PAGE_SIZE.
+     */
+    const uint32_t LOG_SEEK_MAGIC = 0x4B534647; // "GFSK"
+    const uint16_t LOG_SEEK_MAX = 126; // Хвост целиком укладывается в две страницы
+
+    struct __attribute__((packed)) LogSeekHeader
+    {
+        uint32_t magic;
+        uint16_t count;
+        uint16_t stride; // Страниц между соседними отметками
+    };
+
+    /**
+     * Заголовок индекса логов: по нему индекс другого формата (старый размер
+     * записи) распознается и строится заново
+     */
+    const uint32_t LOG_INDEX_MAGIC = 0x58494647; // "GFIX"
+    const uint16_t LOG_INDEX_VERSION = 1;
+
+    struct __attribute__((packed)) LogIndexHeader
+    {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t entrySize; // sizeof(LogIndexEntry)
+    };
+
+    /**
+     * Запись индекса логов (/logs.idx), по одной на полет
+     */
+    struct __attribute__((packed)) LogIndexEntry
+    {
+        uint32_t flightId;
+        uint32_t startMillis;   // millis() в момент старта
+        int32_t firstTimeMs;    // Время первой записи (< 0 — предзапись)
+        int32_t lastTimeMs;     // Время последней записи
+        uint32_t records;
+        int32_t maxAltitudeCm;
+        uint32_t seekOffset;    // Смещение таблицы поиска = конец страниц с данными
+        uint32_t fileSize;
+        // Сводка полета (FlightStats)
+        int32_t timeOfMaxMs;
+        int32_t launchHeightCm;
+        int32_t launchEndMs;
+        int32_t sinkRateCmS;
+    };
+
+    static_assert(sizeof(LogRecord) == 16, "LogRecord must stay 16 bytes");
+    static_assert(sizeof(LogHeader) <= LOG_PAGE_SIZE, "LogHeader must fit into one page");
+
+    const size_t LOG_RECORDS_PER_PAGE = LOG_PAGE_SIZE / sizeof(LogRecord);
+}
+
+#endif
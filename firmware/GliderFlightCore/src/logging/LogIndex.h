@@ -0,0 +1,205 @@
+#ifndef LOG_INDEX_H
+#define LOG_INDEX_H
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include "LogFormat.h"
+#include "LogCodec.h"
+#include "LogBlock.h"
+#include "LogSeek.h"
+#include "FlightStats.h"
+#include "../config/Config.h"
+#include "../core/Storage.h"
+
+namespace Logging
+{
+    /**
+     * Индекс логов /logs.idx: LogIndexHeader и массив LogIndexEntry фиксированного
+     * размера, дописывается самописцем в конце каждого полета. Список полетов и поиск
+     * по времени читают только индекс и хвост лога, не трогая записи.
+     */
+
+    /**
+     * Заполняет поля сводки записи индекса
+     */
+    void applyStats(LogIndexEntry &entry, const FlightStats &stats)
+    {
+        entry.maxAltitudeCm = stats.maxAltitudeCm;
+        entry.timeOfMaxMs = stats.timeOfMaxMs;
+        entry.launchHeightCm = stats.launchHeightCm;
+        entry.launchEndMs = stats.launchEndMs;
+        entry.sinkRateCmS = stats.sinkRateCmS();
+    }
+
+    /**
+     * Открывает индекс на чтение и пропускает заголовок. Индекс без заголовка
+     * или другого формата считается отсутствующим (закрытый File).
+     */
+    File openIndex()
+    {
+        File file = LittleFS.open(LOG_INDEX_FILE, "r");
+        if (!file)
+            return file;
+        LogIndexHeader header;
+        if (file.read((uint8_t *)&header, sizeof(header)) != sizeof(header) || header.magic != LOG_INDEX_MAGIC ||
+            header.version != LOG_INDEX_VERSION || header.entrySize != sizeof(LogIndexEntry))
+        {
+            file.close();
+            return File();
+        }
+        return file;
+    }
+
+    /**
+     * Удаляет индекс другого формата (например, от прошивки со старым размером
+     * записи). Вызывается в setup() до первого чтения индекса.
+     */
+    void checkIndex()
+    {
+        if (!LittleFS.exists(LOG_INDEX_FILE))
+            return;
+        File index = openIndex();
+        if (index)
+        {
+            index.close();
+            return;
+        }
+        Serial.println("[Index] Формат индекса изменился, перестройка");
+        LittleFS.remove(LOG_INDEX_FILE);
+    }
+
+    bool appendIndex(const LogIndexEntry &entry)
+    {
+        File file = LittleFS.open(LOG_INDEX_FILE, "a");
+        if (!file)
+            return false;
+        bool ok = true;
+        if (file.size() == 0)
+        {
+            LogIndexHeader header = {LOG_INDEX_MAGIC, LOG_INDEX_VERSION, sizeof(LogIndexEntry)};
+            ok = file.write((const uint8_t *)&header, sizeof(header)) == sizeof(header);
+        }
+        ok = ok && file.write((const uint8_t *)&entry, sizeof(entry)) == sizeof(entry);
+        file.close();
+        return ok;
+    }
+
+    bool findIndex(uint32_t flightId, LogIndexEntry &out)
+    {
+        File file = openIndex();
+        if (!file)
+            return false;
+        bool found = false;
+        while (!found && file.read((uint8_t *)&out, sizeof(out)) == sizeof(out))
+            found = out.flightId == flightId;
+        file.close();
+        return found;
+    }
+
+    /**
+     * Запись индекса по содержимому лога (лог без индекса: сброс в полете,
+     * восстановление из флеш-кольца, файлы старых версий)
+     */
+    bool scanLog(uint32_t flightId, LogIndexEntry &entry)
+    {
+        File file = LittleFS.open(Storage::logPath(flightId), "r");
+        if (!file)
+            return false;
+        LogHeader header;
+        uint8_t page[LOG_PAGE_SIZE];
+        if (file.read(page, LOG_PAGE_SIZE) != LOG_PAGE_SIZE)
+        {
+            file.close();
+            return false;
+        }
+        memcpy(&header, page, sizeof(header));
+
+        memset(&entry, 0, sizeof(entry));
+        entry.flightId = flightId;
+        entry.startMillis = header.startMillis;
+        entry.seekOffset = entry.fileSize = file.size();
+
+        // Вертикальной скорости в записях нет — оценка по высотам за окно
+        FlightStats stats;
+        stats.reset();
+        VspeedWindow vspeed;
+        vspeed.reset();
+        uint32_t offset = LOG_PAGE_SIZE;
+        size_t len;
+        while ((len = file.read(page, LOG_PAGE_SIZE)) > 0)
+        {
+            uint32_t magic;
+            memcpy(&magic, page, sizeof(magic));
+            if (magic == LOG_SEEK_MAGIC)
+            {
+                entry.seekOffset = offset;
+                break;
+            }
+            // Журналируемый лог читается до первого битого блока
+            if (header.version >= 4 && !blockValid(page, len, offset / LOG_PAGE_SIZE))
+                break;
+            LogRecord rec;
+            if (header.encoding == LOG_ENCODING_DELTA)
+            {
+                PageDecoder decoder(page, pagePayload(header.version, len));
+                while (decoder.next(rec))
+                {
+                    if (entry.records++ == 0)
+                        entry.firstTimeMs = rec.timeMs;
+                    entry.lastTimeMs = rec.timeMs;
+                    stats.add(rec.timeMs, rec.altitudeCm, vspeed.add(rec.timeMs, rec.altitudeCm));
+                }
+            }
+            offset += len;
+            yield();
+        }
+        file.close();
+        applyStats(entry, stats);
+        return true;
+    }
+
+    /**
+     * Дописывает в индекс логи, которых в нем нет. Вызывается в setup()
+     * после checkIndex().
+     */
+    void syncIndex()
+    {
+        LogIndexEntry entry;
+        Dir dir = LittleFS.openDir("/");
+        while (dir.next())
+        {
+            uint32_t id = Storage::logIdFromName(dir.fileName());
+            if (id == 0 || findIndex(id, entry))
+                continue;
+            if (scanLog(id, entry) && appendIndex(entry))
+                Serial.printf("[Index] Лог %u добавлен в индекс\n", id);
+        }
+    }
+
+    /**
+     * Байтовый диапазон страниц лога с записями from..to мс по таблице поиска
+     */
+    bool findTimeRange(const LogIndexEntry &entry, int32_t from, int32_t to, uint32_t &start, uint32_t &end)
+    {
+        start = LOG_PAGE_SIZE;
+        end = entry.seekOffset;
+        if (entry.seekOffset >= entry.fileSize)
+            return true; // Таблицы нет — весь лог
+
+        File file = LittleFS.open(Storage::logPath(entry.flightId), "r");
+        if (!file)
+            return false;
+        LogSeekHeader header;
+        int32_t times[LOG_SEEK_MAX];
+        file.seek(entry.seekOffset, SeekSet);
+        bool ok = file.read((uint8_t *)&header, sizeof(header)) == sizeof(header) &&
+                  header.magic == LOG_SEEK_MAGIC && header.count <= LOG_SEEK_MAX &&
+                  file.read((uint8_t *)times, header.count * sizeof(int32_t)) == header.count * sizeof(int32_t);
+        file.close();
+        if (ok)
+            seekRange(header, times, entry.seekOffset, from, to, start, end);
+        return ok;
+    }
+}
+
+#endif
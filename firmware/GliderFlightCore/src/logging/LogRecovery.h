@@ -0,0 +1,135 @@
+#ifndef LOG_RECOVERY_H
+#define LOG_RECOVERY_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <LittleFS.h>
+#include "LogFormat.h"
+#include "LogBlock.h"
+#include "LogIndex.h"
+#include "../config/Config.h"
+#include "../core/Storage.h"
+
+namespace Logging
+{
+    /**
+     * Итог восстановления недописанного лога при загрузке (для /system)
+     */
+    struct RecoveryReport
+    {
+        const char *status = "clean"; // clean | truncated | damaged | removed
+        uint32_t flightId = 0;
+        uint32_t sizeBefore = 0;
+        uint32_t bytesKept = 0;
+        uint16_t blocksChecked = 0;
+        uint32_t durationUs = 0;
+
+        void serialize(JsonObject &doc) const
+        {
+            doc["status"] = status;
+            doc["flight"] = flightId;
+            doc["size_before"] = sizeBefore;
+            doc["bytes_kept"] = bytesKept;
+            doc["bytes_dropped"] = sizeBefore - bytesKept;
+            doc["blocks_checked"] = blocksChecked;
+            doc["us"] = durationUs;
+        }
+    } recovery;
+
+    /**
+     * Таблица поиска, начинающаяся в блоке block, дописана до конца файла
+     */
+    bool seekTailComplete(const uint8_t *page, uint32_t block, uint32_t blocks)
+    {
+        LogSeekHeader seek;
+        memcpy(&seek, page, sizeof(seek));
+        if (seek.magic != LOG_SEEK_MAGIC || seek.count > LOG_SEEK_MAX)
+            return false;
+        uint32_t tailPages = (sizeof(seek) + seek.count * sizeof(int32_t) + LOG_PAGE_SIZE - 1) / LOG_PAGE_SIZE;
+        return block + tailPages == blocks;
+    }
+
+    /**
+     * Восстановление после сброса питания в полете. Недописанным может быть
+     * только последний лог без записи в индексе. LittleFS после сброса
+     * откатывает файл к последней синхронизации, поэтому проверяются блоки с
+     * конца: первый целый блок (CRC, метка, номер) — граница, все за ним
+     * отрезается. Проверяется не больше LOG_RECOVERY_MAX_BLOCKS блоков —
+     * время не зависит от длины лога. Вызывается в setup() до syncIndex().
+     */
+    void recoverLog()
+    {
+        uint32_t startUs = micros();
+        uint32_t id = Storage::findNextLogId() - 1;
+        LogIndexEntry entry;
+        if (id == 0 || findIndex(id, entry))
+            return;
+
+        String path = Storage::logPath(id);
+        File file = LittleFS.open(path, "r+");
+        if (!file)
+            return;
+        recovery.flightId = id;
+        recovery.sizeBefore = file.size();
+
+        uint8_t page[LOG_PAGE_SIZE];
+        LogHeader header;
+        if (file.read(page, LOG_PAGE_SIZE) != LOG_PAGE_SIZE)
+        {
+            // Даже заголовок не успел записаться — восстанавливать нечего
+            file.close();
+            LittleFS.remove(path);
+            recovery.status = "removed";
+            recovery.durationUs = micros() - startUs;
+            Serial.printf("[Recovery] Лог %u пуст, удален\n", id);
+            return;
+        }
+        memcpy(&header, page, sizeof(header));
+        bool headerOk = blockValid(page, LOG_PAGE_SIZE, 0);
+        if (header.magic != LOG_MAGIC || header.version < 4)
+        {
+            // Логи до v4 без журнала: оставляются как есть
+            file.close();
+            recovery.bytesKept = recovery.sizeBefore;
+            return;
+        }
+
+        uint32_t blocks = recovery.sizeBefore / LOG_PAGE_SIZE;
+        uint32_t keep = blocks;
+        bool found = false;
+        while (keep > 1 && recovery.blocksChecked < LOG_RECOVERY_MAX_BLOCKS)
+        {
+            uint32_t block = keep - 1;
+            recovery.blocksChecked++;
+            file.seek(block * LOG_PAGE_SIZE, SeekSet);
+            size_t len = file.read(page, LOG_PAGE_SIZE);
+            if (blockValid(page, len, block))
+            {
+                found = true;
+                break;
+            }
+            // Таблица поиска не запечатана: целая — лог закрыт, не успел только индекс
+            if (len == LOG_PAGE_SIZE && seekTailComplete(page, block, blocks))
+            {
+                keep = blocks;
+                found = true;
+                break;
+            }
+            keep = block;
+        }
+        if (keep <= 1)
+            found = headerOk;
+
+        recovery.bytesKept = keep * LOG_PAGE_SIZE;
+        if (recovery.bytesKept < recovery.sizeBefore)
+            file.truncate(recovery.bytesKept);
+        file.close();
+
+        recovery.status = !found ? "damaged" : recovery.bytesKept < recovery.sizeBefore ? "truncated" : "clean";
+        recovery.durationUs = micros() - startUs;
+        Serial.printf("[Recovery] Лог %u: %s, оставлено %u из %u байт, проверено блоков %u, %u мкс\n", id,
+                      recovery.status, recovery.bytesKept, recovery.sizeBefore, recovery.blocksChecked, recovery.durationUs);
+    }
+}
+
+#endif
@@ -0,0 +1,96 @@
+#ifndef LOG_SEEK_H
+#define LOG_SEEK_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "LogFormat.h"
+
+namespace Logging
+{
+    /**
+     * Построитель таблицы поиска: время ключевого кадра каждой stride-й страницы.
+     * Память фиксирована (LOG_SEEK_MAX отметок): при заполнении каждая вторая
+     * отметка выбрасывается, а шаг удваивается, так что таблица покрывает
+     * полет любой длины.
+     */
+    class SeekTable
+    {
+    private:
+        int32_t _times[LOG_SEEK_MAX];
+        uint16_t _count = 0;
+        uint16_t _stride = 1;
+        uint32_t _pages = 0;
+
+    public:
+        void reset()
+        {
+            _count = 0;
+            _stride = 1;
+            _pages = 0;
+        }
+
+        /**
+         * Очередная страница данных с ключевым кадром во время keyTimeMs
+         */
+        void addPage(int32_t keyTimeMs)
+        {
+            uint32_t page = _pages++;
+            if (page % _stride)
+                return;
+            if (_count == LOG_SEEK_MAX)
+            {
+                for (uint16_t i = 0; i < _count / 2; i++)
+                    _times[i] = _times[2 * i];
+                _count /= 2;
+                _stride *= 2;
+                if (page % _stride)
+                    return;
+            }
+            _times[_count++] = keyTimeMs;
+        }
+
+        uint32_t pages() const { return _pages; }
+
+        /**
+         * Размер хвоста лога в байтах (без выравнивания по странице)
+         */
+        size_t size() const { return sizeof(LogSeekHeader) + _count * sizeof(int32_t); }
+
+        void serialize(uint8_t *out) const
+        {
+            LogSeekHeader header = {LOG_SEEK_MAGIC, _count, _stride};
+            memcpy(out, &header, sizeof(header));
+            memcpy(out + sizeof(header), _times, _count * sizeof(int32_t));
+        }
+    };
+
+    /**
+     * Байтовый диапазон страниц [start, end), покрывающий записи с from..to мс.
+     * times/header — таблица поиска, dataEnd — смещение таблицы в файле.
+     */
+    inline void seekRange(const LogSeekHeader &header, const int32_t *times, uint32_t dataEnd,
+                          int32_t from, int32_t to, uint32_t &start, uint32_t &end)
+    {
+        uint32_t first = 0;
+        uint32_t last = (dataEnd - LOG_PAGE_SIZE + LOG_PAGE_SIZE - 1) / LOG_PAGE_SIZE;
+        for (uint16_t i = 0; i < header.count; i++)
+        {
+            if (times[i] <= from)
+                first = (uint32_t)i * header.stride;
+            if (times[i] > to)
+            {
+                last = (uint32_t)i * header.stride;
+                break;
+            }
+        }
+        start = (first + 1) * LOG_PAGE_SIZE;
+        end = (last + 1) * LOG_PAGE_SIZE;
+        if (end > dataEnd)
+            end = dataEnd;
+        if (start > end)
+            start = end;
+    }
+}
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef LOG_SINK_H
+#define LOG_SINK_H
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include "LogFormat.h"
+#include "../config/Config.h"
+#include "../core/Storage.h"
+#include "../diagnostics/Profiler.h"
+
+namespace Logging
+{
+    /**
+     * Хранилище страниц лога. Самописец отдает ему страницы по LOG_PAGE_SIZE
+     * байт (нулевая — заголовок), последняя страница может быть короче.
+     */
+    class LogSink
+    {
+    public:
+        virtual ~LogSink() {}
+        virtual const char *name() const = 0;
+        virtual bool open(uint32_t flightId) = 0;
+        virtual bool write(const uint8_t *page, size_t length) = 0;
+        virtual void close() = 0;
+        // Подготовка на земле (ARMED), вызывается из loop()
+        virtual void prepare() {}
+    };
+
+    /**
+     * Запись прямо в log_N.dat на LittleFS
+     */
+    class LittleFsSink : public LogSink
+    {
+    private:
+        File _file;
+        uint32_t _pages = 0;
+
+    public:
+        const char *name() const override { return "littlefs"; }
+
+        bool open(uint32_t flightId) override
+        {
+            _file = Storage::createLog(flightId);
+            _pages = 0;
+            return (bool)_file;
+        }
+
+        bool write(const uint8_t *page, size_t length) override
+        {
+            Diagnostics::PerfScope perf(Diagnostics::PERF_FS_WRITE);
+            bool ok = _file.write(page, length) == length;
+            // Заголовок фиксируется сразу: после сброса файл опознается и восстанавливается
+            if (++_pages % LOG_SYNC_PAGES == 0 || _pages == 1)
+                _file.flush();
+            return ok;
+        }
+
+        void close() override { _file.close(); }
+    };
+
+    LittleFsSink fsSink;
+}
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef RECORD_RING_H
+#define RECORD_RING_H
+
+#include <stddef.h>
+#include "LogFormat.h"
+
+namespace Logging
+{
+    /**
+     * Кольцо записей лога фиксированной емкости (статический массив, без кучи).
+     * В ARMED работает как предзапись: новые записи затирают самые старые,
+     * в полете — как очередь перед кодером, переполнение отбрасывает новые.
+     */
+    template <size_t N>
+    class RecordRing
+    {
+    private:
+        LogRecord _data[N];
+        size_t _head = 0; // Самая старая запись
+        size_t _count = 0;
+
+    public:
+        /**
+         * false, если кольцо полно и overwrite == false
+         */
+        bool push(const LogRecord &rec, bool overwrite)
+        {
+            if (_count == N)
+            {
+                if (!overwrite)
+                    return false;
+                _head = (_head + 1) % N;
+                _count--;
+            }
+            _data[(_head + _count) % N] = rec;
+            _count++;
+            return true;
+        }
+
+        bool peek(LogRecord &out) const
+        {
+            if (_count == 0)
+                return false;
+            out = _data[_head];
+            return true;
+        }
+
+        void pop()
+        {
+            if (_count == 0)
+                return;
+            _head = (_head + 1) % N;
+            _count--;
+        }
+
+        void reset() { _head = _count = 0; }
+        size_t size() const { return _count; }
+        bool empty() const { return _count == 0; }
+    };
+}
+
+#endif
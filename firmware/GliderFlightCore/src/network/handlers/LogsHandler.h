@@ -0,0 +1,358 @@
+#ifndef LOGS_HANDLER_H
+#define LOGS_HANDLER_H
+
+#include <ArduinoJson.h>
+#include <LittleFS.h>
+#include "../../core/Storage.h"
+#include "../../logging/LogIndex.h"
+#include "../../logging/Downsample.h"
+#include "../WebServer.h"
+
+namespace Network
+{
+    // Кусок потоковой отдачи: один TCP-сегмент (MSS), статический — RAM не зависит от размера лога
+    const size_t LOG_STREAM_CHUNK = 1460;
+    uint8_t logStreamBuffer[LOG_STREAM_CHUNK];
+
+    /**
+     * Скорость последней выгрузки лога (для /logs и заголовка X-Last-Download)
+     */
+    struct DownloadStats
+    {
+        uint32_t id = 0;
+        uint32_t bytes = 0;
+        uint32_t ms = 0;
+
+        uint32_t kbps() const { return ms ? (uint32_t)((uint64_t)bytes * 8 / ms) : 0; }
+    } lastDownload;
+
+    /**
+     * Разбор заголовка Range: "bytes=a-b", "bytes=a-", "bytes=-n" (одиночный диапазон).
+     * false, если диапазон не попадает в файл.
+     */
+    bool parseRange(const String &header, size_t size, size_t &start, size_t &end)
+    {
+        if (!header.startsWith("bytes=") || size == 0)
+            return false;
+        String spec = header.substring(6);
+        int dash = spec.indexOf('-');
+        if (dash < 0 || spec.indexOf(',') >= 0)
+            return false;
+        String from = spec.substring(0, dash);
+        String to = spec.substring(dash + 1);
+
+        if (from.length() == 0)
+        {
+            // Последние n байт
+            size_t suffix = to.toInt();
+            if (suffix == 0)
+                return false;
+            start = suffix >= size ? 0 : size - suffix;
+            end = size - 1;
+            return true;
+        }
+        start = from.toInt();
+        end = to.length() ? min((size_t)to.toInt(), size - 1) : size - 1;
+        return start <= end && start < size;
+    }
+
+    /**
+     * GET /logs — список логов по индексу /logs.idx (потоком, без сборки всего ответа в RAM)
+     */
+    void handleLogList()
+    {
+        Serial.println("[HTTP] Запрос списка логов /logs");
+
+        server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+        server.send(200, "application/json", "");
+        server.sendContent("{\"logs\":[");
+
+        bool first = true;
+        File index = Logging::openIndex();
+        Logging::LogIndexEntry e;
+        while (index && index.read((uint8_t *)&e, sizeof(e)) == sizeof(e))
+        {
+            StaticJsonDocument<256> entry;
+            entry["id"] = e.flightId;
+            entry["size"] = e.fileSize;
+            entry["records"] = e.records;
+            entry["start_ms"] = e.startMillis;
+            entry["first_ms"] = e.firstTimeMs;
+            entry["duration_ms"] = e.lastTimeMs;
+            entry["max_alt"] = e.maxAltitudeCm / 100.0f;
+            String item = first ? "" : ",";
+            serializeJson(entry, item);
+            server.sendContent(item);
+            first = false;
+        }
+        if (index)
+            index.close();
+
+        StaticJsonDocument<128> stats;
+        stats["id"] = lastDownload.id;
+        stats["bytes"] = lastDownload.bytes;
+        stats["ms"] = lastDownload.ms;
+        stats["kbps"] = lastDownload.kbps();
+        String tail = "],\"last_download\":";
+        serializeJson(stats, tail);
+        tail += "}";
+        server.sendContent(tail);
+        server.sendContent("");
+    }
+
+    /**
+     * GET /logs/<n>/summary — сводка полета из индекса (FlightStats), без чтения лога,
+     * и отчет исполнителя программы /servo_N.json (план и факт шагов), если он есть
+     */
+    void handleLogSummary()
+    {
+        uint32_t id = server.pathArg(0).toInt();
+        Serial.printf("[HTTP] Сводка полета %u\n", id);
+
+        Logging::LogIndexEntry e;
+        if (!Logging::findIndex(id, e))
+        {
+            server.send(404, "text/plain", "Log not found");
+            return;
+        }
+
+        StaticJsonDocument<256> doc;
+        doc["id"] = e.flightId;
+        doc["records"] = e.records;
+        doc["duration"] = e.lastTimeMs / 1000.0f;
+        doc["max_alt"] = e.maxAltitudeCm / 100.0f;
+        doc["time_to_max"] = e.timeOfMaxMs / 1000.0f;
+        doc["launch_height"] = e.launchHeightCm / 100.0f;
+        doc["launch_time"] = e.launchEndMs / 1000.0f;
+        doc["sink_rate"] = e.sinkRateCmS / 100.0f;
+
+        String output;
+        serializeJson(doc, output);
+        File report = LittleFS.open(String(SERVO_REPORT_PREFIX) + String(id) + ".json", "r");
+        if (report)
+        {
+            output = output.substring(0, output.length() - 1) + ",\"servo\":" + report.readString() + "}";
+            report.close();
+        }
+        server.send(200, "application/json", output);
+    }
+
+    /**
+     * Отдача [start, end] файла кусками напрямую в сокет
+     */
+    size_t streamRange(File &file, size_t start, size_t end)
+    {
+        WiFiClient client = server.client();
+        file.seek(start, SeekSet);
+        size_t left = end - start + 1;
+        size_t sent = 0;
+        while (left > 0 && client.connected())
+        {
+            size_t n = file.read(logStreamBuffer, min(left, LOG_STREAM_CHUNK));
+            if (n == 0)
+                break;
+            size_t written = client.write(logStreamBuffer, n);
+            sent += written;
+            if (written != n)
+                break;
+            left -= n;
+        }
+        return sent;
+    }
+
+    /**
+     * GET /logs/<n>?from=&to= — фрагмент лога: страница заголовка и страницы
+     * с записями в интервале from..to мс (по таблице поиска, без чтения записей)
+     */
+    size_t sendTimeRange(File &file, uint32_t id)
+    {
+        Logging::LogIndexEntry entry;
+        uint32_t start, end;
+        int32_t from = server.hasArg("from") ? server.arg("from").toInt() : INT32_MIN;
+        int32_t to = server.hasArg("to") ? server.arg("to").toInt() : INT32_MAX;
+        if (!Logging::findIndex(id, entry) || !Logging::findTimeRange(entry, from, to, start, end))
+        {
+            server.send(404, "text/plain", "Log index not found");
+            return 0;
+        }
+        server.setContentLength(Logging::LOG_PAGE_SIZE + end - start);
+        server.send(200, "application/octet-stream", "");
+        size_t sent = streamRange(file, 0, Logging::LOG_PAGE_SIZE - 1);
+        if (end > start)
+            sent += streamRange(file, start, end - 1);
+        return sent;
+    }
+
+    // Прореживание для графиков: кандидатов на корзину и предел точек в ответе
+    const uint16_t LOG_PLOT_MAX_POINTS = 2000;
+    const size_t LOG_PLOT_CHUNK = 512;
+    Logging::LttbSampler<64> plotSampler;
+
+    struct PlotStream
+    {
+        String chunk;
+        bool first;
+        size_t sent;
+    };
+
+    void sendPlotChunk(PlotStream &stream)
+    {
+        server.sendContent(stream.chunk);
+        stream.sent += stream.chunk.length();
+        stream.chunk = "";
+    }
+
+    void onPlotPoint(int32_t t, int32_t altitudeCm, void *context)
+    {
+        PlotStream &stream = *(PlotStream *)context;
+        if (!stream.first)
+            stream.chunk += ",";
+        stream.first = false;
+        stream.chunk += "[" + String(t) + "," + String(altitudeCm / 100.0f, 2) + "]";
+        if (stream.chunk.length() >= LOG_PLOT_CHUNK)
+            sendPlotChunk(stream);
+    }
+
+    /**
+     * Записи страниц [start, end) с временем from..to: передаются в sampler
+     * (если задан), возвращается их число
+     */
+    uint32_t forEachPlotRecord(File &file, const Logging::LogHeader &header, uint32_t start, uint32_t end,
+                               int32_t from, int32_t to, Logging::LttbSampler<64> *sampler)
+    {
+        uint8_t page[Logging::LOG_PAGE_SIZE];
+        uint32_t count = 0;
+        file.seek(start, SeekSet);
+        for (uint32_t offset = start; offset < end; offset += Logging::LOG_PAGE_SIZE)
+        {
+            size_t len = file.read(page, sizeof(page));
+            Logging::PageDecoder decoder(page, Logging::pagePayload(header.version, len));
+            Logging::LogRecord rec;
+            while (decoder.next(rec))
+            {
+                if (rec.timeMs < from || rec.timeMs > to)
+                    continue;
+                count++;
+                if (sampler)
+                    sampler->add(rec.timeMs, rec.altitudeCm);
+            }
+            yield();
+        }
+        return count;
+    }
+
+    /**
+     * GET /logs/<n>?points=N&from=&to= — высота, прореженная LTTB до N точек.
+     * Один проход по страницам интервала, память постоянна; ответ — JSON потоком.
+     */
+    size_t sendPlot(File &file, uint32_t id)
+    {
+        Logging::LogIndexEntry entry;
+        if (!Logging::findIndex(id, entry))
+        {
+            server.send(404, "text/plain", "Log index not found");
+            return 0;
+        }
+        uint32_t points = constrain(server.arg("points").toInt(), 2, LOG_PLOT_MAX_POINTS);
+        int32_t from = server.hasArg("from") ? max((int32_t)server.arg("from").toInt(), entry.firstTimeMs) : entry.firstTimeMs;
+        int32_t to = server.hasArg("to") ? min((int32_t)server.arg("to").toInt(), entry.lastTimeMs) : entry.lastTimeMs;
+
+        uint32_t start, end;
+        Logging::LogHeader header;
+        uint8_t page[Logging::LOG_PAGE_SIZE];
+        if (!Logging::findTimeRange(entry, from, to, start, end) ||
+            file.read(page, sizeof(page)) != sizeof(page))
+        {
+            server.send(500, "text/plain", "Log read error");
+            return 0;
+        }
+        memcpy(&header, page, sizeof(header));
+        if (header.version < 2 || header.encoding != Logging::LOG_ENCODING_DELTA)
+        {
+            server.send(400, "text/plain", "Unsupported log encoding");
+            return 0;
+        }
+
+        server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+        server.send(200, "application/json", "");
+        PlotStream stream = {"{\"id\":" + String(id) + ",\"from\":" + String(from) + ",\"to\":" + String(to) + ",\"points\":[", true, 0};
+
+        // Корзины LTTB равны по числу записей: для всего полета оно есть в индексе,
+        // для интервала — отдельный счетный проход по тем же страницам
+        uint32_t total = entry.records;
+        if (from != entry.firstTimeMs || to != entry.lastTimeMs)
+            total = forEachPlotRecord(file, header, start, end, from, to, nullptr);
+        plotSampler.begin(total, points, onPlotPoint, &stream);
+        forEachPlotRecord(file, header, start, end, from, to, &plotSampler);
+        plotSampler.finish();
+
+        stream.chunk += "]}";
+        sendPlotChunk(stream);
+        server.sendContent("");
+        return stream.sent;
+    }
+
+    /**
+     * GET /logs/<n> — файл log_n.dat целиком или по Range (206) для докачки
+     */
+    void handleLogDownload()
+    {
+        uint32_t id = server.pathArg(0).toInt();
+        String path = Storage::logPath(id);
+        Serial.printf("[HTTP] Выгрузка лога %s\n", path.c_str());
+
+        File file = id ? LittleFS.open(path, "r") : File();
+        if (!file)
+        {
+            server.send(404, "text/plain", "Log not found");
+            return;
+        }
+        size_t size = file.size();
+
+        server.sendHeader("X-Last-Download", String(lastDownload.kbps()) + " kbps");
+
+        uint32_t startMs = millis();
+        size_t sent;
+        if (server.hasArg("points"))
+        {
+            sent = sendPlot(file, id);
+            file.close();
+            Serial.printf("[HTTP] График лога %u: %u байт за %lu мс\n", id, sent, millis() - startMs);
+            return;
+        }
+
+        server.sendHeader("Accept-Ranges", "bytes");
+        server.sendHeader("Content-Disposition", "attachment; filename=log_" + String(id) + ".dat");
+        if (server.hasArg("from") || server.hasArg("to"))
+        {
+            sent = sendTimeRange(file, id);
+        }
+        else if (server.hasHeader("Range"))
+        {
+            size_t start, end;
+            if (!parseRange(server.header("Range"), size, start, end))
+            {
+                server.sendHeader("Content-Range", "bytes */" + String(size));
+                server.send(416, "text/plain", "Range Not Satisfiable");
+                file.close();
+                return;
+            }
+            server.sendHeader("Content-Range", "bytes " + String(start) + "-" + String(end) + "/" + String(size));
+            server.setContentLength(end - start + 1);
+            server.send(206, "application/octet-stream", "");
+            sent = streamRange(file, start, end);
+        }
+        else
+        {
+            sent = server.streamFile(file, "application/octet-stream");
+        }
+        file.close();
+
+        lastDownload.id = id;
+        lastDownload.bytes = sent;
+        lastDownload.ms = millis() - startMs;
+        Serial.printf("[HTTP] Лог %u: %u байт за %u мс (%u кбит/с)\n", id, lastDownload.bytes, lastDownload.ms, lastDownload.kbps());
+    }
+}
+
+#endif
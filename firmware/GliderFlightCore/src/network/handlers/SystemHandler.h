@@ -3,6 +3,12 @@
 
 #include <ArduinoJson.h>
 #include <LittleFS.h>
+#include "../../core/Sensors.h"
+#include "../../logging/FlightRecorder.h"
+#include "../../core/Scheduler.h"
+#include "../../diagnostics/Profiler.h"
+#include "../../diagnostics/LaunchLatency.h"
+#include "../../actuators/ServoExecutor.h"
 #include "../WebServer.h"
 
 namespace Network
@@ -14,7 +20,7 @@ namespace Network
     {
         Serial.println("[HTTP] Запрос диагностики /system");
 
-        StaticJsonDocument<256> doc;
+        StaticJsonDocument<1536> doc;
 
         // Время работы в секундах
         doc["uptime"] = millis() / 1000;
@@ -36,12 +42,76 @@ namespace Network
         // Версия прошивки (из Config.h)
         doc["version"] = VERSION;
 
+        // Расписание отсчетов барометра: джиттер и пропущенные дедлайны
+        JsonObject sampling = doc.createNestedObject("sampling");
+        Sensors::sampling.serialize(sampling);
+
+        // Бортовой самописец: хранилище и задержки записи
+        JsonObject recorder = doc.createNestedObject("recorder");
+        Logging::recorder.serialize(recorder);
+
+        // Исполнитель программы: текущий импульс и точность шагов последнего полета
+        JsonObject servo = doc.createNestedObject("servo");
+        Actuators::servo.serialize(servo);
+
+        // Задачи планировщика loop(): время выполнения и превышения бюджета
+        JsonArray tasks = doc.createNestedArray("tasks");
+        Scheduler::serialize(tasks);
+
         String output;
         serializeJson(doc, output);
         server.send(200, "application/json", output);
         Serial.println("[HTTP] Ответ отправлен (System Health)");
         Serial.println(output);
     }
+
+    /**
+     * GET /system/perf[?reset=1] — время участков кода (задачи loop(),
+     * HTTP-обработчики, чтение датчика, фильтр, запись лога). Потоком, по
+     * объекту на участок; с reset=1 статистика обнуляется после ответа.
+     */
+    void handleSystemPerf()
+    {
+        Serial.println("[HTTP] Запрос профиля /system/perf");
+        using Diagnostics::profiler;
+
+        server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+        server.send(200, "application/json", "");
+        server.sendContent("{\"cpu_mhz\":" + String(ESP.getCpuFreqMHz()) +
+                           ",\"window_ms\":" + String(millis() - profiler.since()) + ",\"probes\":[");
+        for (uint8_t i = 0; i < profiler.size(); i++)
+        {
+            StaticJsonDocument<256> entry;
+            JsonObject probe = entry.to<JsonObject>();
+            profiler.serialize(i, probe);
+            String item = i ? "," : "";
+            serializeJson(entry, item);
+            server.sendContent(item);
+        }
+        server.sendContent("]}");
+        server.sendContent("");
+
+        if (server.hasArg("reset") && server.arg("reset") != "0")
+            profiler.reset();
+    }
+
+    /**
+     * GET /system/launch[?reset=1] — задержка пуска по этапам (сборка с LAUNCH_LATENCY)
+     */
+    void handleLaunchLatency()
+    {
+        Serial.println("[HTTP] Запрос задержки пуска /system/launch");
+        StaticJsonDocument<768> doc;
+        JsonObject root = doc.to<JsonObject>();
+        Diagnostics::launchLatency.serialize(root);
+
+        String output;
+        serializeJson(doc, output);
+        server.send(200, "application/json", output);
+
+        if (server.hasArg("reset") && server.arg("reset") != "0")
+            Diagnostics::launchLatency.clear();
+    }
 }
 
 #endif
\ No newline at end of file
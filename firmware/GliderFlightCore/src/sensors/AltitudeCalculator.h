@@ -3,61 +3,41 @@
 
 #include <math.h>
 #include "BarometerDriver.h"
+#include "AltitudeKernel.h"
+#include "SampleBuffer.h"
 #include "KalmanFilter.h"
 #include "Calibration.h"
 #include "TelemetryData.h"
 #include "../config/Config.h"
+#include "../diagnostics/Profiler.h"
 
 namespace Sensors
 {
-    class PressureSampler
-    {
-        double accumulator = 0;
-        uint32_t count = 0;
-
-    public:
-        void add(double p)
-        {
-            accumulator += p;
-            count++;
-        }
-        double getAverageAndReset()
-        {
-            if (count == 0)
-                return 0;
-            double avg = accumulator / (double)count;
-            accumulator = 0;
-            count = 0;
-            return avg;
-        }
-        void reset()
-        {
-            accumulator = 0;
-            count = 0;
-        }
-    };
-
     struct AltimeterConfig
     {
-        const float altFactor = 44330.0;
-        const float altExponent = 0.190295;
+        const ReducerType reducer = REDUCER_HAMPEL;
+        const float kalmanQ = 1.0;  // Дисперсия вертикального ускорения, (м/с^2)^2
+        const float kalmanR = 0.3;  // Дисперсия измерения высоты, м^2
         const float stabilityThreshold = 0.25;
         const float deadZone = 0.12;
-        const unsigned long interval = BARO_INTERVAL;
     };
 
     extern CalibrationData calData;
     const AltimeterConfig cfg;
     TelemetryData telemetry;
-    PressureSampler sampler;
+    SampleRing<SAMPLE_RING_CAPACITY> sampler;
     StabilityMonitor stability(cfg.stabilityThreshold);
-    KalmanState kAlt = {0.05, 0.3, 0, 1, 0};
+    KalmanState kAlt = {cfg.kalmanQ, cfg.kalmanR, 0, 0, 1, 0, 1, 0, 0};
+#ifdef KALMAN_FIXED_POINT
+    KalmanFixedState kAltFixed;
+#endif
+    unsigned long outputInterval = BARO_INTERVAL; // Период расчета высоты, мс
     unsigned long logStartTime = 0;
     unsigned long last_log_time = 0;
 
-    void updateAdaptiveBaseline(float alpha)
+    void updateAdaptiveBaseline(PressureMilliPa pressure, AlphaQ16 alpha)
     {
-        calData.adaptiveBaseline = calData.adaptiveBaseline * (1.0 - alpha) + telemetry.pressure * alpha;
+        blendMilliPa(calData.adaptiveBaseline, calData.adaptiveFraction, pressure, alpha);
     }
 
     void logTelemetry(unsigned long now)
@@ -70,16 +50,57 @@ namespace Sensors
             Serial.print("s] ");
             Serial.print("Alt: ");
             Serial.print(telemetry.altitude, 2);
-            Serial.print("m | P: ");
-            Serial.print(telemetry.pressure, 1);
+            Serial.print("m | Vz: ");
+            Serial.print(telemetry.verticalSpeed, 2);
+            Serial.print("m/s | P: ");
+            Serial.print(telemetry.pressure);
             Serial.print("Pa | ");
             Serial.println(telemetry.isStable ? "STABLE" : "MOVING");
         }
     }
 
-    void processTelemetryOutput(float rawAltitude, unsigned long now)
+    void resetAltitudeFilter()
     {
-        telemetry.altitude = kalmanUpdate(&kAlt, rawAltitude);
+        kalmanReset(&kAlt, 0);
+#ifdef KALMAN_FIXED_POINT
+        kalmanFixedInit(&kAltFixed, cfg.kalmanQ, cfg.kalmanR, outputInterval);
+        kAltFixed.h = kAltFixed.v = 0;
+#endif
+    }
+
+    /**
+     * Смена периода расчета высоты (бортовой самописец пишет каждый расчет)
+     */
+    void setOutputInterval(unsigned long ms)
+    {
+        if (ms == outputInterval)
+            return;
+        outputInterval = ms;
+#ifdef KALMAN_FIXED_POINT
+        kalmanFixedInit(&kAltFixed, cfg.kalmanQ, cfg.kalmanR, outputInterval);
+#endif
+    }
+
+    /**
+     * Фильтр высоты/вариометра. Возвращает высоту, скорость пишет в телеметрию.
+     */
+    float filterAltitude(float rawAltitude, float dt)
+    {
+        Diagnostics::PerfScope perf(Diagnostics::PERF_FILTER);
+#ifdef KALMAN_FIXED_POINT
+        kalmanFixedUpdate(&kAltFixed, (int32_t)(rawAltitude * 1000));
+        telemetry.verticalSpeed = kAltFixed.v / 1000.0f;
+        return kAltFixed.h / 1000.0f;
+#else
+        kalmanUpdate(&kAlt, rawAltitude, dt);
+        telemetry.verticalSpeed = kAlt.v;
+        return kAlt.h;
+#endif
+    }
+
+    void processTelemetryOutput(float rawAltitude, float dt, unsigned long now)
+    {
+        telemetry.altitude = filterAltitude(rawAltitude, dt);
         if (abs(telemetry.altitude) < cfg.deadZone)
             telemetry.altitude = 0.00;
         telemetry.temperature = readTemperature();
@@ -87,27 +108,37 @@ namespace Sensors
         logTelemetry(now);
     }
 
-    void performCalculations(unsigned long now)
+    void performCalculations(unsigned long now, float dt)
     {
-        telemetry.pressure = sampler.getAverageAndReset();
+        PressureMilliPa pressure = sampler.reduceAndReset(getReducer(cfg.reducer));
+        telemetry.pressure = roundToPascals(pressure);
+        telemetry.timestamp = now;
+        telemetry.seq++;
         if (!sys.calibrated)
             return;
-        float rawAltitude = cfg.altFactor * (1.0 - pow(telemetry.pressure / calData.adaptiveBaseline, cfg.altExponent));
-        float alpha = stability.process(rawAltitude);
-        updateAdaptiveBaseline(alpha);
-        processTelemetryOutput(rawAltitude, now);
+        float rawAltitude = altitudeFromRatio((float)pressure / (float)calData.adaptiveBaseline);
+        AlphaQ16 alpha = stability.process(rawAltitude);
+        updateAdaptiveBaseline(pressure, alpha);
+        processTelemetryOutput(rawAltitude, dt, now);
+    }
+
+    void addAltitudeSample(const BaroSample &sample)
+    {
+        sampler.add(sample.pressure);
     }
 
     void updateAltitude()
     {
         if (!sys.hardwareOK || !sys.monitoring)
             return;
-        sampler.add(readPressure());
         unsigned long now = millis();
-        if (now - last_log_time >= cfg.interval)
+        unsigned long elapsed = now - last_log_time;
+        // При периоде короче шага отсчетов ждем хотя бы один отсчет
+        if (elapsed >= outputInterval && sampler.size() > 0)
         {
             last_log_time = now;
-            performCalculations(now);
+            // После паузы мониторинга шаг ограничивается, чтобы не раскачать прогноз
+            performCalculations(now, min(elapsed, 2 * outputInterval) / 1000.0f);
         }
     }
 }
@@ -0,0 +1,100 @@
+#ifndef ALTITUDE_KERNEL_H
+#define ALTITUDE_KERNEL_H
+
+#include <Arduino.h>
+#include <math.h>
+
+namespace Sensors
+{
+    /**
+     * Ядро "отношение давлений -> высота" без pow().
+     *
+     * У ESP8266 нет FPU, и pow() в performCalculations() эмулируется программно.
+     * Здесь кривая h(r) = ALT_FACTOR * (1 - r^ALT_EXPONENT) табулирована на этапе
+     * компиляции (constexpr) и во время работы берется линейной интерполяцией:
+     * одна таблица в PROGMEM, пара умножений и сложений float на вызов.
+     *
+     * Диапазон: r = p / p0 в [0.88, 1.12] (примерно от -1000 до +1100 м
+     * относительно точки обнуления), 256 сегментов.
+     * Погрешность относительно точной формулы в double: не более 1 мм во всем
+     * диапазоне (интерполяция h'' * step^2 / 8 ~ 0.9 мм плюс округление float;
+     * проверено перебором 2e6 точек). Шум BMP180 (~0.25 м) на порядки больше.
+     * За пределами диапазона используется исходная формула с pow().
+     */
+    namespace AltKernel
+    {
+        constexpr double ALT_FACTOR = 44330.0;
+        constexpr double ALT_EXPONENT = 0.190295;
+        constexpr double RATIO_MIN = 0.88;
+        constexpr double RATIO_MAX = 1.12;
+        constexpr int SEGMENTS = 256;
+        constexpr double STEP = (RATIO_MAX - RATIO_MIN) / SEGMENTS;
+
+        // Ряды для вычисления таблицы компилятором (аргументы близки к 1 и к 0)
+        constexpr double lnNearOne(double x)
+        {
+            double y = (x - 1.0) / (x + 1.0);
+            double y2 = y * y;
+            double term = y;
+            double sum = 0;
+            for (int n = 1; n < 40; n += 2)
+            {
+                sum += term / n;
+                term *= y2;
+            }
+            return 2.0 * sum;
+        }
+
+        constexpr double expSmall(double z)
+        {
+            double term = 1.0;
+            double sum = 1.0;
+            for (int n = 1; n < 30; n++)
+            {
+                term *= z / n;
+                sum += term;
+            }
+            return sum;
+        }
+
+        constexpr double exactAltitude(double ratio)
+        {
+            return ALT_FACTOR * (1.0 - expSmall(ALT_EXPONENT * lnNearOne(ratio)));
+        }
+
+        struct Table
+        {
+            float v[SEGMENTS + 1];
+        };
+
+        constexpr Table makeTable()
+        {
+            Table t{};
+            for (int i = 0; i <= SEGMENTS; i++)
+                t.v[i] = (float)exactAltitude(RATIO_MIN + STEP * i);
+            return t;
+        }
+
+        static const Table TABLE PROGMEM = makeTable();
+
+        constexpr float RATIO_MIN_F = (float)RATIO_MIN;
+        constexpr float INV_STEP_F = (float)(1.0 / STEP);
+    }
+
+    /**
+     * Высота (м) по отношению текущего давления к базовому
+     */
+    float altitudeFromRatio(float ratio)
+    {
+        float pos = (ratio - AltKernel::RATIO_MIN_F) * AltKernel::INV_STEP_F;
+        if (pos < 0 || pos >= AltKernel::SEGMENTS)
+            return (float)AltKernel::ALT_FACTOR * (1.0f - powf(ratio, (float)AltKernel::ALT_EXPONENT));
+        int idx = (int)pos;
+        float frac = pos - idx;
+        float a = pgm_read_float(&AltKernel::TABLE.v[idx]);
+        float b = pgm_read_float(&AltKernel::TABLE.v[idx + 1]);
+        return a + (b - a) * frac;
+    }
+}
+
+#endif
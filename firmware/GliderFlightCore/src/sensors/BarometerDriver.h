@@ -2,15 +2,256 @@
 #define BAROMETER_DRIVER_H
 
 #include <Wire.h>
-#include <Adafruit_BMP085.h>
 #include "../config/Config.h"
+#include "../diagnostics/Profiler.h"
 
 namespace Sensors
 {
     struct SystemStatus;
     extern SystemStatus sys;
 
-    Adafruit_BMP085 bmp;
+    /**
+     * Value Object: Готовый отсчет барометра.
+     */
+    struct BaroSample
+    {
+        int32_t pressure = 0;        // Па
+        float temperature = 0;       // °C
+        unsigned long timestamp = 0; // мс (millis() на момент чтения результата)
+    };
+
+    /**
+     * Неблокирующий драйвер BMP180.
+     * Конвертация разделена на "запуск" и "опрос результата": вместо delay() внутри
+     * библиотеки драйвер запоминает момент запуска и забирает данные только когда
+     * истекло время преобразования по даташиту. Вызов poll() никогда не ждет.
+     *
+     * Кэш компенсации: температура меняется медленно, поэтому коэффициент B5
+     * пересчитывается раз в _tempIntervalMs, а все промежуточные отсчеты давления
+     * используют сохраненное значение. Так почти каждый цикл — это только
+     * преобразование давления.
+     */
+    class Bmp180Driver
+    {
+    private:
+        static const uint8_t ADDR = 0x77;
+        static const uint8_t REG_CALIB = 0xAA;
+        static const uint8_t REG_CHIP_ID = 0xD0;
+        static const uint8_t REG_CONTROL = 0xF4;
+        static const uint8_t REG_DATA = 0xF6;
+        static const uint8_t CMD_TEMPERATURE = 0x2E;
+        static const uint8_t CMD_PRESSURE = 0x34;
+        static const uint8_t CHIP_ID = 0x55;
+
+        enum Phase
+        {
+            PHASE_IDLE,
+            PHASE_TEMPERATURE,
+            PHASE_PRESSURE
+        };
+
+        // Калибровочные коэффициенты из EEPROM датчика
+        int16_t ac1, ac2, ac3, b1, b2, mb, mc, md;
+        uint16_t ac4, ac5, ac6;
+
+        uint8_t _oss = BMP180_OSS;
+        Phase _phase = PHASE_IDLE;
+        uint32_t _conversionStart = 0;
+        int32_t _b5 = 0;
+        bool _b5Valid = false;
+        uint32_t _lastTempUs = 0;
+        uint32_t _tempIntervalMs = BARO_TEMP_INTERVAL;
+
+        BaroSample _sample;
+        bool _fresh = false;
+        uint32_t _errors = 0;
+
+        bool writeRegister(uint8_t reg, uint8_t value)
+        {
+            Wire.beginTransmission(ADDR);
+            Wire.write(reg);
+            Wire.write(value);
+            return Wire.endTransmission() == 0;
+        }
+
+        bool readRegisters(uint8_t reg, uint8_t *buf, uint8_t len)
+        {
+            Diagnostics::PerfScope perf(Diagnostics::PERF_BARO_READ);
+            Wire.beginTransmission(ADDR);
+            Wire.write(reg);
+            if (Wire.endTransmission(false) != 0)
+                return false;
+            if (Wire.requestFrom(ADDR, len) != len)
+                return false;
+            for (uint8_t i = 0; i < len; i++)
+                buf[i] = Wire.read();
+            return true;
+        }
+
+        bool readCoefficients()
+        {
+            uint8_t raw[22];
+            if (!readRegisters(REG_CALIB, raw, sizeof(raw)))
+                return false;
+            ac1 = (raw[0] << 8) | raw[1];
+            ac2 = (raw[2] << 8) | raw[3];
+            ac3 = (raw[4] << 8) | raw[5];
+            ac4 = (raw[6] << 8) | raw[7];
+            ac5 = (raw[8] << 8) | raw[9];
+            ac6 = (raw[10] << 8) | raw[11];
+            b1 = (raw[12] << 8) | raw[13];
+            b2 = (raw[14] << 8) | raw[15];
+            mb = (raw[16] << 8) | raw[17];
+            mc = (raw[18] << 8) | raw[19];
+            md = (raw[20] << 8) | raw[21];
+            return true;
+        }
+
+        void computeB5(int32_t ut)
+        {
+            int32_t x1 = ((ut - (int32_t)ac6) * (int32_t)ac5) >> 15;
+            int32_t x2 = ((int32_t)mc << 11) / (x1 + (int32_t)md);
+            _b5 = x1 + x2;
+        }
+
+        /**
+         * Целочисленная компенсация давления по алгоритму из даташита BMP180
+         */
+        int32_t compensatePressure(int32_t up) const
+        {
+            int32_t b6 = _b5 - 4000;
+            int32_t x1 = ((int32_t)b2 * ((b6 * b6) >> 12)) >> 11;
+            int32_t x2 = ((int32_t)ac2 * b6) >> 11;
+            int32_t x3 = x1 + x2;
+            int32_t b3 = ((((int32_t)ac1 * 4 + x3) << _oss) + 2) / 4;
+
+            x1 = ((int32_t)ac3 * b6) >> 13;
+            x2 = ((int32_t)b1 * ((b6 * b6) >> 12)) >> 16;
+            x3 = ((x1 + x2) + 2) >> 2;
+            uint32_t b4 = ((uint32_t)ac4 * (uint32_t)(x3 + 32768)) >> 15;
+            uint32_t b7 = ((uint32_t)up - b3) * (uint32_t)(50000UL >> _oss);
+
+            int32_t p = (b7 < 0x80000000) ? (b7 * 2) / b4 : (b7 / b4) * 2;
+            x1 = (p >> 8) * (p >> 8);
+            x1 = (x1 * 3038) >> 16;
+            x2 = (-7357 * p) >> 16;
+            return p + ((x1 + x2 + (int32_t)3791) >> 4);
+        }
+
+        bool startConversion(Phase phase, uint32_t nowUs)
+        {
+            uint8_t cmd = (phase == PHASE_TEMPERATURE) ? CMD_TEMPERATURE : CMD_PRESSURE + (_oss << 6);
+            if (!writeRegister(REG_CONTROL, cmd))
+                return fail();
+            _phase = phase;
+            _conversionStart = nowUs;
+            return false;
+        }
+
+        bool fail()
+        {
+            _errors++;
+            _phase = PHASE_IDLE;
+            return false;
+        }
+
+        uint32_t conversionTime() const
+        {
+            return (_phase == PHASE_TEMPERATURE) ? BMP180_TEMP_CONVERSION_US : BMP180_PRESSURE_CONVERSION_US[_oss];
+        }
+
+    public:
+        bool begin(uint8_t oss)
+        {
+            _oss = oss > 3 ? 3 : oss;
+            _phase = PHASE_IDLE;
+            _fresh = false;
+            _b5Valid = false;
+            uint8_t id = 0;
+            if (!readRegisters(REG_CHIP_ID, &id, 1) || id != CHIP_ID)
+                return false;
+            return readCoefficients();
+        }
+
+        bool temperatureDue(uint32_t nowUs) const
+        {
+            return !_b5Valid || (nowUs - _lastTempUs) / 1000 >= _tempIntervalMs;
+        }
+
+        /**
+         * Шаг машины состояний: IDLE -> [TEMPERATURE ->] PRESSURE -> IDLE.
+         * Температура запрашивается только когда истек интервал прореживания.
+         * Возвращает true, если в этом вызове был получен новый отсчет.
+         */
+        bool poll(uint32_t nowUs)
+        {
+            if (_phase == PHASE_IDLE)
+                return startConversion(temperatureDue(nowUs) ? PHASE_TEMPERATURE : PHASE_PRESSURE, nowUs);
+
+            if (nowUs - _conversionStart < conversionTime())
+                return false;
+
+            uint8_t raw[3];
+            if (_phase == PHASE_TEMPERATURE)
+            {
+                if (!readRegisters(REG_DATA, raw, 2))
+                    return fail();
+                computeB5((raw[0] << 8) | raw[1]);
+                _b5Valid = true;
+                _lastTempUs = nowUs;
+                return startConversion(PHASE_PRESSURE, nowUs);
+            }
+
+            if (!readRegisters(REG_DATA, raw, 3))
+                return fail();
+            int32_t up = (((int32_t)raw[0] << 16) | ((int32_t)raw[1] << 8) | raw[2]) >> (8 - _oss);
+            _sample.pressure = compensatePressure(up);
+            // Без округления до 0.1 °C из даташита: мелкий шаг нужен детектору прогрева
+            _sample.temperature = (_b5 + 8) / 160.0f;
+            _sample.timestamp = millis();
+            _fresh = true;
+            _phase = PHASE_IDLE;
+            return true;
+        }
+
+        /**
+         * Бросает незавершенное преобразование: результат в регистрах датчика
+         * просто не читается, следующий poll() начнет цикл заново
+         */
+        void abort() { _phase = PHASE_IDLE; }
+
+        /**
+         * Забирает последний готовый отсчет (почтовый ящик на один элемент)
+         */
+        bool take(BaroSample &out)
+        {
+            if (!_fresh)
+                return false;
+            out = _sample;
+            _fresh = false;
+            return true;
+        }
+
+        /**
+         * Период обновления температурной компенсации (0 — каждый отсчет)
+         */
+        void setTemperatureInterval(uint32_t ms) { _tempIntervalMs = ms; }
+
+        /**
+         * Идет ли преобразование и сколько еще ждать его результата
+         */
+        bool busy() const { return _phase != PHASE_IDLE; }
+        uint32_t remainingUs(uint32_t nowUs) const
+        {
+            uint32_t elapsed = nowUs - _conversionStart;
+            return (busy() && elapsed < conversionTime()) ? conversionTime() - elapsed : 0;
+        }
+
+        const BaroSample &last() const { return _sample; }
+        uint32_t errors() const { return _errors; }
+    };
+
+    Bmp180Driver bmp;
 
     /**
      * Инициализация шины I2C с использованием динамических пинов
@@ -20,8 +261,9 @@ namespace Sensors
         // Применяем пины из конфигурации
         Serial.printf("[Sensors] Инициализация I2C (SDA:%d, SCL:%d)...\n", pins.sda, pins.scl);
         Wire.begin(pins.sda, pins.scl);
+        Wire.setClock(I2C_CLOCK_HZ);
 
-        if (!bmp.begin(BMP085_ULTRAHIGHRES))
+        if (!bmp.begin(BMP180_OSS))
         {
             sys.hardwareOK = false;
             Serial.println("[Sensors] ОШИБКА: Датчик BMP180 не найден на шине I2C!");
@@ -33,14 +275,9 @@ namespace Sensors
         }
     }
 
-    double readPressure()
-    {
-        return bmp.readPressure();
-    }
-
     float readTemperature()
     {
-        return bmp.readTemperature();
+        return bmp.last().temperature;
     }
 }
-#endif
\ No newline at end of file
+#endif
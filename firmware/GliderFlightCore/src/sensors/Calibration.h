@@ -6,6 +6,7 @@
 #include "fsm/WarmupState.h"
 #include "fsm/MeasuringState.h"
 #include "fsm/ZeroingState.h"
+#include "LoopBudget.h"
 #include "../core/Storage.h"
 
 namespace Sensors
@@ -18,20 +19,24 @@ namespace Sensors
 
     CalibrationState *currentState = &idleStateObj;
 
+    // Темп и стоимость калибровки для /status
+    RateMeter calibRate;
+    uint32_t sensorLoopMaxUs = 0;
+
     /**
      * Реализация функций переходов
      */
-    void transitionToIdle()
+    void changeState(CalibrationState *newState)
     {
-        currentState = &idleStateObj;
+        currentState->onExit();
+        currentState = newState;
+        calibRate.reset(millis());
+        sensorLoopMaxUs = 0;
         currentState->onEnter();
     }
 
-    void transitionToMeasuring()
-    {
-        currentState = &measuringStateObj;
-        currentState->onEnter();
-    }
+    void transitionToIdle() { changeState(&idleStateObj); }
+    void transitionToMeasuring() { changeState(&measuringStateObj); }
 
     // API управления калибровкой
     bool isCalibrationIdle() { return currentState->isIdle(); }
@@ -42,8 +47,7 @@ namespace Sensors
             return;
         Serial.println("[Sensors] Запуск неблокирующей калибровки...");
         sys.calibrated = false;
-        currentState = &warmupStateObj;
-        currentState->onEnter();
+        changeState(&warmupStateObj);
     }
 
     void startZeroing()
@@ -51,8 +55,7 @@ namespace Sensors
         if (!sys.hardwareOK)
             return;
         Serial.println("[Sensors] Запуск неблокирующего обнуления...");
-        currentState = &zeroingStateObj;
-        currentState->onEnter();
+        changeState(&zeroingStateObj);
     }
 
     void cancel()
@@ -75,7 +78,7 @@ namespace Sensors
         {
             calData.storedBasePressure = calData.basePressure;
             Serial.print("[Sensors] Калибровка сохранена в ФС: ");
-            Serial.println(calData.storedBasePressure, 2);
+            Serial.println(toPascals(calData.storedBasePressure), 2);
             return true;
         }
         return false;
@@ -85,10 +88,10 @@ namespace Sensors
     {
         if (calData.deserialize(Storage::loadCalibration()))
         {
-            kAlt.x = 0;
+            resetAltitudeFilter();
             sys.calibrated = true;
             Serial.print("[Sensors] Данные успешно загружены из ФС: ");
-            Serial.println(calData.storedBasePressure);
+            Serial.println(toPascals(calData.storedBasePressure));
         }
     }
 }
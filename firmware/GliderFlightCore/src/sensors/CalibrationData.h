@@ -2,6 +2,7 @@
 #define CALIBRATION_DATA_H
 
 #include <ArduinoJson.h>
+#include "Pressure.h"
 
 namespace Sensors
 {
@@ -11,14 +12,21 @@ namespace Sensors
      */
     struct CalibrationData
     {
-        double basePressure = 0;
-        double adaptiveBaseline = 0;
-        double storedBasePressure = 0;
+        PressureMilliPa basePressure = 0;
+        PressureMilliPa adaptiveBaseline = 0;
+        uint16_t adaptiveFraction = 0; // Дробная часть базы ниже 1 мПа, Q16
+        PressureMilliPa storedBasePressure = 0;
+
+        // Качество последней калибровки (не сохраняется в ФС)
+        float noisePa = 0;     // СКО одиночного отсчета
+        float semPa = 0;       // Стандартная ошибка полученной базы
+        uint32_t samples = 0;  // Сколько отсчетов потребовалось
 
         String serialize() const
         {
             StaticJsonDocument<128> doc;
-            doc["basePressure"] = basePressure;
+            // В файле хранится в Па, как и раньше: формат calib.json не меняется
+            doc["basePressure"] = basePressure / (double)MILLIPA_PER_PA;
             String output;
             serializeJson(doc, output);
             return output;
@@ -35,7 +43,8 @@ namespace Sensors
                 double val = doc["basePressure"];
                 if (val > 0)
                 {
-                    basePressure = adaptiveBaseline = storedBasePressure = val;
+                    basePressure = adaptiveBaseline = storedBasePressure = fromPascals(val);
+                    adaptiveFraction = 0;
                     return true;
                 }
             }
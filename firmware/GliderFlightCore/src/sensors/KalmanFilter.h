@@ -1,27 +1,96 @@
 #ifndef KALMAN_FILTER_H
 #define KALMAN_FILTER_H
 
+#include <Arduino.h>
+
 namespace Sensors
 {
     /**
-     * Состояние фильтра Калмана
+     * Состояние фильтра Калмана "высота + вертикальная скорость".
+     * Модель постоянной скорости, ускорение — белый шум с дисперсией q.
+     * Ковариация 2x2 симметрична, поэтому хранятся только p00, p01, p11.
      */
     struct KalmanState
     {
-        float q, r, x, p, k;
+        float q;   // Дисперсия ускорения, (м/с^2)^2
+        float r;   // Дисперсия измерения высоты, м^2
+        float h;   // Высота, м
+        float v;   // Вертикальная скорость, м/с
+        float p00, p01, p11;
+        float k0, k1; // Последние коэффициенты усиления
+    };
+
+    void kalmanReset(KalmanState *state, float altitude)
+    {
+        state->h = altitude;
+        state->v = 0;
+        state->p00 = state->p11 = 1;
+        state->p01 = 0;
+    }
+
+    /**
+     * Прогноз на dt секунд и коррекция по измерению высоты. Возвращает высоту.
+     */
+    float kalmanUpdate(KalmanState *state, float measurement, float dt)
+    {
+        float dt2 = dt * dt;
+        float qdt2 = state->q * dt2;
+
+        // Прогноз: x = F x, P = F P F^T + Q
+        state->h += state->v * dt;
+        state->p00 += dt * (2 * state->p01 + dt * state->p11) + qdt2 * dt2 * 0.25f;
+        state->p01 += dt * state->p11 + qdt2 * dt * 0.5f;
+        state->p11 += qdt2;
+
+        // Коррекция
+        float s = state->p00 + state->r;
+        state->k0 = state->p00 / s;
+        state->k1 = state->p01 / s;
+        float innovation = measurement - state->h;
+        state->h += state->k0 * innovation;
+        state->v += state->k1 * innovation;
+
+        state->p11 -= state->k1 * state->p01;
+        state->p01 -= state->k0 * state->p01;
+        state->p00 -= state->k0 * state->p00;
+        return state->h;
+    }
+
+    /**
+     * Вариант без float на каждом отсчете: при постоянном dt коэффициенты
+     * усиления фильтра Калмана сходятся к константам, поэтому они один раз
+     * вычисляются из float-модели, а обновление идет в целых (мм, мм/с, Q16).
+     */
+    struct KalmanFixedState
+    {
+        int32_t h;  // мм
+        int32_t v;  // мм/с
+        int32_t k0; // Q16
+        int32_t k1; // Q16, 1/с
+        int32_t dtMs;
     };
 
     /**
-     * Обновление фильтра Калмана
+     * Пересчет установившихся коэффициентов под шаг dtMs (состояние h, v не трогается)
      */
-    float kalmanUpdate(KalmanState *state, float measurement)
+    void kalmanFixedInit(KalmanFixedState *state, float q, float r, uint32_t dtMs)
+    {
+        KalmanState model = {q, r, 0, 0, 1, 0, 1, 0, 0};
+        for (int i = 0; i < 200; i++)
+            kalmanUpdate(&model, 0, dtMs / 1000.0f);
+        state->k0 = (int32_t)(model.k0 * 65536);
+        state->k1 = (int32_t)(model.k1 * 65536);
+        state->dtMs = dtMs;
+    }
+
+    int32_t kalmanFixedUpdate(KalmanFixedState *state, int32_t measurementMm)
     {
-        state->p = state->p + state->q;
-        state->k = state->p / (state->p + state->r);
-        state->x = state->x + state->k * (measurement - state->x);
-        state->p = (1 - state->k) * state->p;
-        return state->x;
+        state->h += (int32_t)((int64_t)state->v * state->dtMs / 1000);
+        int32_t innovation = measurementMm - state->h;
+        state->h += (int32_t)(((int64_t)innovation * state->k0) >> 16);
+        state->v += (int32_t)(((int64_t)innovation * state->k1) >> 16);
+        return state->h;
     }
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,59 @@
+#ifndef LOOP_BUDGET_H
+#define LOOP_BUDGET_H
+
+#include <Arduino.h>
+
+namespace Sensors
+{
+    /**
+     * Бюджет времени на один проход loop(): работа, которую можно отложить,
+     * выполняется только пока бюджет не исчерпан.
+     */
+    class LoopBudget
+    {
+    private:
+        uint32_t _start;
+        uint32_t _budgetUs;
+
+    public:
+        LoopBudget(uint32_t budgetUs) : _start(micros()), _budgetUs(budgetUs) {}
+        uint32_t elapsed() const { return micros() - _start; }
+        bool exhausted() const { return elapsed() >= _budgetUs; }
+    };
+
+    /**
+     * Измеритель частоты событий (отсчетов в секунду) по окнам фиксированной длины
+     */
+    class RateMeter
+    {
+    private:
+        static const unsigned long WINDOW_MS = 1000;
+        unsigned long _windowStart = 0;
+        uint32_t _count = 0;
+        float _rate = 0;
+
+    public:
+        void add(unsigned long now)
+        {
+            _count++;
+            unsigned long elapsed = now - _windowStart;
+            if (elapsed >= WINDOW_MS)
+            {
+                _rate = _count * 1000.0f / elapsed;
+                _count = 0;
+                _windowStart = now;
+            }
+        }
+
+        void reset(unsigned long now)
+        {
+            _windowStart = now;
+            _count = 0;
+            _rate = 0;
+        }
+
+        float rate() const { return _rate; }
+    };
+}
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef PRESSURE_H
+#define PRESSURE_H
+
+#include <Arduino.h>
+
+namespace Sensors
+{
+    /**
+     * Давление с фиксированной точкой: миллипаскали в int32.
+     * Диапазон до ~2147 гПа, шаг 0.001 Па — точнее, чем нужно для усреднения
+     * тысяч отсчетов BMP180 (разрешение датчика 1 Па), и без soft-double на ESP8266.
+     */
+    using PressureMilliPa = int32_t;
+
+    const int32_t MILLIPA_PER_PA = 1000;
+
+    // Коэффициенты сглаживания в формате Q16 (1.0 = 65536)
+    using AlphaQ16 = uint32_t;
+    const int ALPHA_Q16_SHIFT = 16;
+
+    /**
+     * Среднее целых отсчетов (Па) в миллипаскалях с округлением
+     */
+    PressureMilliPa averageMilliPa(int64_t sumPa, uint32_t count)
+    {
+        if (count == 0)
+            return 0;
+        return (PressureMilliPa)((sumPa * MILLIPA_PER_PA + count / 2) / count);
+    }
+
+    /**
+     * Экспоненциальное сглаживание: value += (target - value) * alpha.
+     * Остаток шага ниже 1 мПа копится в fraction (Q16), иначе при малых alpha
+     * (66 ≈ 0.001) разность меньше ~0.5 Па давала нулевой шаг и база
+     * не отслеживала медленный дрейф.
+     */
+    void blendMilliPa(PressureMilliPa &value, uint16_t &fraction, PressureMilliPa target, AlphaQ16 alpha)
+    {
+        int64_t acc = ((int64_t)value << ALPHA_Q16_SHIFT) + fraction;
+        acc += (int64_t)(target - value) * alpha;
+        value = (PressureMilliPa)(acc >> ALPHA_Q16_SHIFT);
+        fraction = (uint16_t)(acc & ((1 << ALPHA_Q16_SHIFT) - 1));
+    }
+
+    // Граница ввода/вывода (JSON, Serial): перевод в паскали
+    float toPascals(PressureMilliPa p) { return p / (float)MILLIPA_PER_PA; }
+    PressureMilliPa fromPascals(double pa) { return (PressureMilliPa)(pa * MILLIPA_PER_PA + 0.5); }
+    int32_t roundToPascals(PressureMilliPa p) { return (p + MILLIPA_PER_PA / 2) / MILLIPA_PER_PA; }
+}
+
+#endif
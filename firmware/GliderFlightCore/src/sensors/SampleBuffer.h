@@ -0,0 +1,296 @@
+#ifndef SAMPLE_BUFFER_H
+#define SAMPLE_BUFFER_H
+
+#include <Arduino.h>
+#include "Pressure.h"
+
+namespace Sensors
+{
+    /**
+     * Редуктор: сводит n отсчетов (Па) к одному значению (мПа).
+     * data не меняется, scratch — рабочий массив той же длины.
+     */
+    typedef PressureMilliPa (*SampleReducer)(const int32_t *data, int32_t *scratch, size_t n);
+
+    /**
+     * k-я порядковая статистика (quickselect, в среднем O(n)), переставляет a
+     */
+    int32_t selectKth(int32_t *a, size_t n, size_t k)
+    {
+        size_t lo = 0, hi = n - 1;
+        while (lo < hi)
+        {
+            int32_t pivot = a[(lo + hi) / 2];
+            size_t i = lo, j = hi;
+            while (i <= j)
+            {
+                while (a[i] < pivot)
+                    i++;
+                while (a[j] > pivot)
+                    j--;
+                if (i <= j)
+                {
+                    int32_t t = a[i];
+                    a[i] = a[j];
+                    a[j] = t;
+                    i++;
+                    if (j == 0)
+                        break;
+                    j--;
+                }
+            }
+            if (k <= j)
+                hi = j;
+            else if (k >= i)
+                lo = i;
+            else
+                break;
+        }
+        return a[k];
+    }
+
+    /**
+     * Медиана в мПа; для четного n — среднее двух центральных
+     */
+    PressureMilliPa medianMilliPa(int32_t *a, size_t n)
+    {
+        size_t mid = n / 2;
+        int32_t upper = selectKth(a, n, mid);
+        if (n % 2)
+            return upper * MILLIPA_PER_PA;
+        // После selectKth все элементы левее mid не больше a[mid]
+        int32_t lower = a[0];
+        for (size_t i = 1; i < mid; i++)
+            lower = max(lower, a[i]);
+        return averageMilliPa((int64_t)lower + upper, 2);
+    }
+
+    PressureMilliPa sumToMilliPa(const int32_t *a, size_t n)
+    {
+        int64_t sum = 0;
+        for (size_t i = 0; i < n; i++)
+            sum += a[i];
+        return averageMilliPa(sum, n);
+    }
+
+    PressureMilliPa reduceMean(const int32_t *data, int32_t *scratch, size_t n)
+    {
+        return sumToMilliPa(data, n);
+    }
+
+    PressureMilliPa reduceMedian(const int32_t *data, int32_t *scratch, size_t n)
+    {
+        memcpy(scratch, data, sizeof(int32_t) * n);
+        return medianMilliPa(scratch, n);
+    }
+
+    /**
+     * Усеченное среднее: отбрасывает по 20% отсчетов с каждого края
+     */
+    PressureMilliPa reduceTrimmedMean(const int32_t *data, int32_t *scratch, size_t n)
+    {
+        size_t cut = n / 5;
+        if (cut == 0)
+            return sumToMilliPa(data, n);
+        size_t keep = n - 2 * cut;
+        memcpy(scratch, data, sizeof(int32_t) * n);
+        selectKth(scratch, n, cut);
+        selectKth(scratch + cut, n - cut, keep - 1);
+        return sumToMilliPa(scratch + cut, keep);
+    }
+
+    /**
+     * Фильтр Хампеля: отсчеты дальше 3 * 1.4826 * MAD от медианы выбрасываются,
+     * остальные усредняются. MAD не опускается ниже HAMPEL_MIN_MAD_MPA, чтобы
+     * целочисленный шум +-1 Па не считался выбросом.
+     */
+    const int32_t HAMPEL_MIN_MAD_MPA = 500;
+
+    PressureMilliPa reduceHampel(const int32_t *data, int32_t *scratch, size_t n)
+    {
+        if (n < 3)
+            return sumToMilliPa(data, n);
+        PressureMilliPa median = reduceMedian(data, scratch, n);
+
+        // Отклонения в мПа укладываются в int32 для любых реальных отсчетов
+        for (size_t i = 0; i < n; i++)
+            scratch[i] = abs(data[i] * MILLIPA_PER_PA - median);
+        int32_t mad = max(selectKth(scratch, n, n / 2), HAMPEL_MIN_MAD_MPA);
+        int32_t limit = (int32_t)((int64_t)mad * 4448 / 1000);
+
+        int64_t sum = 0;
+        uint32_t kept = 0;
+        for (size_t i = 0; i < n; i++)
+        {
+            if (abs(data[i] * MILLIPA_PER_PA - median) <= limit)
+            {
+                sum += data[i];
+                kept++;
+            }
+        }
+        return kept ? averageMilliPa(sum, kept) : median;
+    }
+
+    enum ReducerType
+    {
+        REDUCER_MEAN,
+        REDUCER_MEDIAN,
+        REDUCER_TRIMMED_MEAN,
+        REDUCER_HAMPEL
+    };
+
+    SampleReducer getReducer(ReducerType type)
+    {
+        switch (type)
+        {
+        case REDUCER_MEDIAN:
+            return reduceMedian;
+        case REDUCER_TRIMMED_MEAN:
+            return reduceTrimmedMean;
+        case REDUCER_HAMPEL:
+            return reduceHampel;
+        default:
+            return reduceMean;
+        }
+    }
+
+    /**
+     * Кольцевой буфер отсчетов фиксированной емкости без динамической памяти.
+     * При переполнении затирает самые старые отсчеты.
+     */
+    template <size_t N>
+    class SampleRing
+    {
+    private:
+        int32_t _data[N];
+        int32_t _scratch[N];
+        size_t _head = 0;
+        size_t _count = 0;
+
+    public:
+        void add(int32_t p)
+        {
+            _data[_head] = p;
+            _head = (_head + 1) % N;
+            if (_count < N)
+                _count++;
+        }
+
+        /**
+         * Сводит накопленные отсчеты редуктором (0, если буфер пуст)
+         */
+        PressureMilliPa reduce(SampleReducer reducer)
+        {
+            if (_count == 0)
+                return 0;
+            // Порядок отсчетов редукторам не важен: при _count < N данные лежат с нуля
+            return reducer(_data, _scratch, _count);
+        }
+
+        PressureMilliPa reduceAndReset(SampleReducer reducer)
+        {
+            PressureMilliPa result = reduce(reducer);
+            reset();
+            return result;
+        }
+
+        void reset()
+        {
+            _head = 0;
+            _count = 0;
+        }
+
+        size_t size() const { return _count; }
+        bool full() const { return _count == N; }
+    };
+
+    /**
+     * Онлайн-среднее и дисперсия по Уэлфорду за O(1) памяти.
+     * Значения сдвигаются на первый отсчет, чтобы float не терял точность
+     * на абсолютных давлениях ~1e8 мПа.
+     */
+    class RunningStats
+    {
+    private:
+        PressureMilliPa _origin = 0;
+        uint32_t _n = 0;
+        float _mean = 0; // мПа относительно _origin
+        float _m2 = 0;
+
+    public:
+        void add(PressureMilliPa value)
+        {
+            if (_n == 0)
+                _origin = value;
+            float x = (float)(value - _origin);
+            _n++;
+            float delta = x - _mean;
+            _mean += delta / _n;
+            _m2 += delta * (x - _mean);
+        }
+
+        uint32_t count() const { return _n; }
+        PressureMilliPa mean() const { return _origin + (PressureMilliPa)lroundf(_mean); }
+        float variance() const { return _n > 1 ? _m2 / (_n - 1) : 0; }
+        float stddev() const { return sqrtf(variance()); }
+        // Стандартная ошибка среднего
+        float sem() const { return _n > 1 ? sqrtf(variance() / _n) : INFINITY; }
+
+        void reset()
+        {
+            _n = 0;
+            _mean = _m2 = 0;
+        }
+    };
+
+    /**
+     * Усреднение длинной серии (калибровка, обнуление) блоками по BLOCK отсчетов:
+     * каждый блок сводится редуктором, итог — среднее по блокам.
+     * С редуктором Хампеля одиночные сбои I2C отбраковываются внутри блока
+     * и не попадают в базу, как это было с простой суммой.
+     */
+    template <size_t BLOCK>
+    class BlockAverager
+    {
+    private:
+        SampleRing<BLOCK> _ring;
+        SampleReducer _reducer;
+        int64_t _sum = 0; // мПа
+        uint32_t _blocks = 0;
+        uint32_t _samples = 0;
+        PressureMilliPa _lastBlock = 0;
+
+    public:
+        BlockAverager(SampleReducer reducer) : _reducer(reducer) {}
+
+        /**
+         * Возвращает true, если этот отсчет закрыл очередной блок
+         */
+        bool add(int32_t p)
+        {
+            _ring.add(p);
+            _samples++;
+            if (!_ring.full())
+                return false;
+            _lastBlock = _ring.reduceAndReset(_reducer);
+            _sum += _lastBlock;
+            _blocks++;
+            return true;
+        }
+
+        PressureMilliPa average() const { return _blocks ? (PressureMilliPa)(_sum / _blocks) : 0; }
+        PressureMilliPa lastBlock() const { return _lastBlock; }
+        uint32_t blocks() const { return _blocks; }
+        uint32_t samples() const { return _samples; }
+
+        void reset()
+        {
+            _ring.reset();
+            _sum = 0;
+            _blocks = 0;
+            _samples = 0;
+        }
+    };
+}
+
+#endif
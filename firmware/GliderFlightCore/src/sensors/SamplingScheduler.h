@@ -0,0 +1,155 @@
+#ifndef SAMPLING_SCHEDULER_H
+#define SAMPLING_SCHEDULER_H
+
+#include <Ticker.h>
+#include <ArduinoJson.h>
+#include "BarometerDriver.h"
+#include "../utils/SpscQueue.h"
+
+namespace Sensors
+{
+    /**
+     * Планировщик отсчетов барометра от таймера (Ticker / os_timer).
+     * Периодический таймер запускает преобразование с точным шагом, одноразовый
+     * таймер забирает результат по истечении времени преобразования. Готовые
+     * отсчеты публикуются в очередь без блокировок, loop() только разбирает ее,
+     * поэтому темп отсчетов больше не зависит от того, как часто крутится loop().
+     *
+     * Колбэки Ticker на ESP8266 выполняются в контексте SDK между проходами
+     * loop(), а не в прерывании, поэтому I2C внутри них безопасен. Опоздание
+     * колбэка за длинным проходом loop() видно в статистике джиттера.
+     */
+    class SamplingScheduler
+    {
+    private:
+        static const size_t QUEUE_SIZE = 16;
+
+        Ticker _tick;
+        Ticker _conversion;
+        Utils::SpscQueue<BaroSample, QUEUE_SIZE> _queue;
+
+        uint32_t _periodUs = 0;
+        bool _running = false;
+
+        // Статистика расписания
+        uint32_t _lastTickUs = 0;
+        uint32_t _ticks = 0;
+        uint32_t _missed = 0;
+        uint32_t _jitterMaxUs = 0;
+        uint64_t _jitterSumUs = 0;
+
+        static void onTickThunk(SamplingScheduler *self) { self->onTick(); }
+        static void onConversionThunk(SamplingScheduler *self) { self->onConversion(); }
+
+        void armConversion(uint32_t nowUs)
+        {
+            uint32_t waitMs = (bmp.remainingUs(nowUs) + 999) / 1000;
+            _conversion.once_ms(max(waitMs, (uint32_t)1), onConversionThunk, this);
+        }
+
+        void onTick()
+        {
+            uint32_t now = micros();
+            if (_ticks > 0)
+            {
+                uint32_t interval = now - _lastTickUs;
+                uint32_t jitter = interval > _periodUs ? interval - _periodUs : _periodUs - interval;
+                _jitterMaxUs = max(_jitterMaxUs, jitter);
+                _jitterSumUs += jitter;
+            }
+            _lastTickUs = now;
+            _ticks++;
+
+            // Колбэк готовности опоздал (Ticker ждал конца прохода loop()),
+            // но результат уже есть — забираем его здесь, это не пропуск
+            if (bmp.busy() && bmp.remainingUs(now) == 0)
+                collect(now);
+
+            // Предыдущее преобразование еще не закончилось — дедлайн пропущен
+            if (bmp.busy())
+            {
+                _missed++;
+                armConversion(now);
+                return;
+            }
+            bmp.poll(now);
+            if (bmp.busy())
+                armConversion(now);
+        }
+
+        void onConversion()
+        {
+            uint32_t now = micros();
+            collect(now);
+            // Следующая фаза (давление после температуры) или ранний колбэк
+            if (bmp.busy())
+                armConversion(now);
+        }
+
+        void collect(uint32_t now)
+        {
+            if (bmp.poll(now))
+            {
+                BaroSample sample;
+                bmp.take(sample);
+                _queue.push(sample);
+            }
+        }
+
+        void resetStats()
+        {
+            _ticks = _missed = _jitterMaxUs = 0;
+            _jitterSumUs = 0;
+        }
+
+    public:
+        /**
+         * Запускает (или перенастраивает) отсчеты с периодом periodUs.
+         * Повторный вызов с тем же периодом ничего не делает.
+         */
+        void start(uint32_t periodUs)
+        {
+            if (_running && periodUs == _periodUs)
+                return;
+            _periodUs = periodUs;
+            _running = true;
+            resetStats();
+            _tick.attach_ms(periodUs / 1000, onTickThunk, this);
+        }
+
+        void stop()
+        {
+            if (!_running)
+                return;
+            _tick.detach();
+            _conversion.detach();
+            // Иначе после следующего start() датчик навсегда "занят" и каждый тик — пропуск
+            bmp.abort();
+            _running = false;
+            _queue.clear();
+        }
+
+        bool take(BaroSample &out) { return _queue.pop(out); }
+
+        void serialize(JsonObject &doc) const
+        {
+            doc["running"] = _running;
+            doc["period_us"] = _periodUs;
+            doc["ticks"] = _ticks;
+            doc["missed"] = _missed;
+            doc["queue_overflows"] = _queue.overflows();
+            doc["jitter_max_us"] = _jitterMaxUs;
+            doc["jitter_avg_us"] = _ticks > 1 ? (uint32_t)(_jitterSumUs / (_ticks - 1)) : 0;
+            doc["i2c_errors"] = bmp.errors();
+        }
+    };
+
+    SamplingScheduler sampling;
+
+    bool takeSample(BaroSample &out)
+    {
+        return sampling.take(out);
+    }
+}
+
+#endif
@@ -12,9 +12,12 @@ namespace Sensors
     struct TelemetryData
     {
         float altitude = 0;
+        float verticalSpeed = 0; // м/с, положительная — набор высоты
         float temperature = 0;
         bool isStable = false;
-        double pressure = 0;
+        int32_t pressure = 0; // Па, среднее за интервал
+        unsigned long timestamp = 0; // мс, момент расчета
+        uint32_t seq = 0;            // Номер расчета: растет при каждом обновлении
 
         void serialize(JsonObject &doc, bool isCalibrated, bool isMonitoring) const
         {
@@ -26,6 +29,7 @@ namespace Sensors
             if (isCalibrated && isMonitoring)
             {
                 doc["alt"] = altitude;
+                doc["vspeed"] = verticalSpeed;
                 doc["temp"] = temperature;
                 doc["stable"] = isStable;
             }
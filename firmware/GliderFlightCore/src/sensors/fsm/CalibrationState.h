@@ -4,6 +4,7 @@
 #include <ArduinoJson.h>
 #include <Arduino.h>
 #include "../../config/Config.h"
+#include "../Pressure.h"
 
 namespace Sensors
 {
@@ -20,13 +21,16 @@ namespace Sensors
     public:
         StabilityMonitor(float threshold) : _threshold(threshold) {}
 
-        float process(float rawAltitude)
+        /**
+         * Возвращает коэффициент адаптации базы в Q16: 0.05 в покое, ~0.001 в движении
+         */
+        AlphaQ16 process(float rawAltitude)
         {
             float altChange = abs(rawAltitude - _lastRawAltitude);
             _stableReadings = (altChange < _threshold) ? _stableReadings + 1 : 0;
             _lastRawAltitude = rawAltitude;
 
-            return (_stableReadings > STABLE_THRESHOLD) ? 0.05 : 0.001;
+            return (_stableReadings > STABLE_THRESHOLD) ? 3277 : 66;
         }
 
         bool isStable() const { return _stableReadings > STABLE_THRESHOLD; }
@@ -55,31 +59,39 @@ namespace Sensors
         }
     };
 
+    struct BaroSample;
+
     /**
      * Базовый интерфейс состояний калибровки.
+     * Отсчеты барометра приходят через onSample(), update() отвечает только за время.
      */
     class CalibrationState
     {
     public:
+        virtual void onSample(const BaroSample &sample) {}
         virtual void update(unsigned long now) = 0;
+        // Период отсчетов барометра в этом состоянии
+        virtual uint32_t samplePeriodUs() { return BARO_SAMPLE_PERIOD_US; }
         virtual int getProgress() = 0;
         virtual String getPhaseName() = 0;
         virtual void serialize(JsonObject &doc) = 0;
         virtual void onEnter() {}
+        virtual void onExit() {}
         virtual bool isMeasuring() { return true; }
         virtual bool isIdle() { return false; }
     };
 
     // Опережающее объявление данных калибровки (они в другом файле)
     struct CalibrationData;
-    struct KalmanState;
 
     // Ссылки на глобальные объекты
     extern SystemStatus sys;
     extern CalibrationData calData;
-    extern KalmanState kAlt;
     extern StabilityMonitor stability;
 
+    // Сброс фильтра высоты после смены базы (AltitudeCalculator.h)
+    void resetAltitudeFilter();
+
     // Опережающие объявления функций переходов
     void transitionToIdle();
     void transitionToMeasuring();
@@ -5,49 +5,93 @@
 #include "../BarometerDriver.h"
 #include "../CalibrationData.h"
 #include "../KalmanFilter.h"
+#include "../SampleBuffer.h"
 
 namespace Sensors
 {
+    /**
+     * Сбор базового давления до сходимости.
+     * Блоки по CALIB_BLOCK_SAMPLES отсчетов (после фильтра Хампеля) независимы,
+     * поэтому ошибка итогового среднего = СКО блоков / sqrt(число блоков).
+     * Калибровка завершается, как только она падает ниже CALIB_SEM_THRESHOLD_PA
+     * (но не раньше CALIB_MIN_SAMPLES и не позже CALIB_MAX_SAMPLES).
+     */
     class MeasuringState : public CalibrationState
     {
     private:
-        int samples = 0;
-        double sum = 0;
-        unsigned long lastSample;
+        BlockAverager<CALIB_BLOCK_SAMPLES> averager{reduceHampel};
+        RunningStats blockStats;
+
+        float semPa() const { return blockStats.sem() / MILLIPA_PER_PA; }
+
+        // Оценка шума одиночного отсчета по разбросу средних блоков
+        float noisePa() const { return blockStats.stddev() * sqrtf(CALIB_BLOCK_SAMPLES) / MILLIPA_PER_PA; }
+
+        bool converged() const
+        {
+            uint32_t n = averager.samples();
+            if (n >= CALIB_MAX_SAMPLES)
+                return true;
+            return n >= CALIB_MIN_SAMPLES && semPa() < CALIB_SEM_THRESHOLD_PA;
+        }
+
+        void finish()
+        {
+            calData.basePressure = blockStats.mean();
+            calData.adaptiveBaseline = calData.basePressure;
+            calData.adaptiveFraction = 0;
+            calData.noisePa = noisePa();
+            calData.semPa = semPa();
+            calData.samples = averager.samples();
+            resetAltitudeFilter();
+            sys.calibrated = true;
+            Serial.print("[Sensors] Калибровка завершена. База: ");
+            Serial.print(toPascals(calData.basePressure), 2);
+            Serial.printf(" Па, отсчетов: %u, шум: %.2f Па, ошибка: %.3f Па\n",
+                          calData.samples, calData.noisePa, calData.semPa);
+            transitionToIdle();
+        }
 
     public:
         void onEnter() override
         {
-            samples = 0;
-            sum = 0;
-            lastSample = millis();
+            averager.reset();
+            blockStats.reset();
         }
-        void update(unsigned long now) override
+        uint32_t samplePeriodUs() override { return CALIB_SAMPLE_PERIOD_US; }
+        void update(unsigned long now) override {}
+        void onSample(const BaroSample &sample) override
         {
-            if (now - lastSample >= 5)
+            if (averager.add(sample.pressure))
             {
-                lastSample = now;
-                sum += readPressure();
-                samples++;
-                if (samples >= 2000)
-                {
-                    calData.basePressure = sum / 2000.0;
-                    calData.adaptiveBaseline = calData.basePressure;
-                    kAlt.x = 0;
-                    sys.calibrated = true;
-                    Serial.print("[Sensors] Калибровка завершена. База: ");
-                    Serial.println(calData.basePressure, 2);
-                    transitionToIdle();
-                }
+                blockStats.add(averager.lastBlock());
+                if (converged())
+                    finish();
             }
         }
-        int getProgress() override { return constrain((samples * 100) / 2000, 0, 99); }
+        /**
+         * Прогресс — большая из двух долей: по лимиту отсчетов и по сходимости
+         * (ошибка среднего убывает как 1/sqrt(n), поэтому доля = (порог / ошибка)^2)
+         */
+        int getProgress() override
+        {
+            int bySamples = (averager.samples() * 100) / CALIB_MAX_SAMPLES;
+            float sem = semPa();
+            int byConvergence = isinf(sem) || sem <= 0 ? 0 : (int)(100 * sq(CALIB_SEM_THRESHOLD_PA / sem));
+            return constrain(max(bySamples, byConvergence), 0, 99);
+        }
         String getPhaseName() override { return "measuring"; }
         void serialize(JsonObject &doc) override
         {
             doc["calibrating"] = true;
             doc["calib_phase"] = getPhaseName();
             doc["calib_progress"] = getProgress();
+            doc["calib_samples"] = averager.samples();
+            if (blockStats.count() > 1)
+            {
+                doc["calib_noise"] = noisePa();
+                doc["calib_sem"] = semPa();
+            }
         }
     };
 }
@@ -6,37 +6,94 @@
 
 namespace Sensors
 {
+    /**
+     * Термостабилизация по факту, а не по таймеру.
+     * Температура сглаживается EMA, раз в WARMUP_WINDOW_MS оценивается ее
+     * производная. Прогрев завершается после WARMUP_SETTLED_WINDOWS окон подряд
+     * с |dT/dt| < WARMUP_SETTLED_SLOPE (не раньше WARMUP_MIN_MS);
+     * WARMUP_MAX_MS остается верхней границей, как прежние 10 секунд.
+     */
     class WarmupState : public CalibrationState
     {
     private:
         unsigned long startTime;
-        unsigned long lastSample;
+        unsigned long windowStart;
+        bool hasTemperature;
+        float smoothedTemp;
+        float windowStartTemp;
+        float slope;
+        int settledWindows;
 
-    public:
-        void onEnter() override { startTime = lastSample = millis(); }
-        void update(unsigned long now) override
+        void processTemperature(float t, unsigned long now)
         {
-            if (now - lastSample >= 50)
+            if (!hasTemperature)
             {
-                lastSample = now;
-                readPressure();
-                readTemperature();
+                hasTemperature = true;
+                smoothedTemp = windowStartTemp = t;
+                windowStart = now;
+                return;
             }
-            if (now - startTime >= 10000)
+            smoothedTemp += (t - smoothedTemp) * 0.2f;
+            if (now - windowStart < WARMUP_WINDOW_MS)
+                return;
+
+            slope = (smoothedTemp - windowStartTemp) * 1000.0f / (now - windowStart);
+            settledWindows = (fabsf(slope) < WARMUP_SETTLED_SLOPE) ? settledWindows + 1 : 0;
+            windowStartTemp = smoothedTemp;
+            windowStart = now;
+        }
+
+        bool isSettled(unsigned long elapsed) const
+        {
+            return elapsed >= WARMUP_MIN_MS && settledWindows >= WARMUP_SETTLED_WINDOWS;
+        }
+
+    public:
+        void onEnter() override
+        {
+            startTime = windowStart = millis();
+            hasTemperature = false;
+            slope = 0;
+            settledWindows = 0;
+            bmp.setTemperatureInterval(WARMUP_TEMP_INTERVAL);
+        }
+        void onExit() override { bmp.setTemperatureInterval(BARO_TEMP_INTERVAL); }
+        // Давление при прогреве не нужно: редкие отсчеты, только ради температуры
+        uint32_t samplePeriodUs() override { return WARMUP_SAMPLE_PERIOD_US; }
+        void onSample(const BaroSample &sample) override
+        {
+            processTemperature(sample.temperature, sample.timestamp);
+        }
+        void update(unsigned long now) override
+        {
+            unsigned long elapsed = now - startTime;
+            if (isSettled(elapsed) || elapsed >= WARMUP_MAX_MS)
             {
-                Serial.println("[Sensors] Термостабилизация завершена -> Сбор данных");
+                Serial.printf("[Sensors] Термостабилизация завершена за %lu мс (dT/dt %.3f °C/с) -> Сбор данных\n",
+                              elapsed, slope);
                 transitionToMeasuring();
             }
         }
-        int getProgress() override { return constrain(((millis() - startTime) * 100) / 10000, 0, 99); }
+        /**
+         * Прогресс — большая из долей: по верхней границе времени и по числу
+         * спокойных окон (с учетом минимального времени)
+         */
+        int getProgress() override
+        {
+            unsigned long elapsed = millis() - startTime;
+            int byTime = (elapsed * 100) / WARMUP_MAX_MS;
+            int bySettling = min(settledWindows * 100 / WARMUP_SETTLED_WINDOWS, (int)(elapsed * 100 / WARMUP_MIN_MS));
+            return constrain(max(byTime, bySettling), 0, 99);
+        }
         String getPhaseName() override { return "stabilization"; }
         void serialize(JsonObject &doc) override
         {
             doc["calibrating"] = true;
             doc["calib_phase"] = getPhaseName();
             doc["calib_progress"] = getProgress();
+            doc["temp_slope"] = slope;
         }
     };
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -5,37 +5,38 @@
 #include "../BarometerDriver.h"
 #include "../CalibrationData.h"
 #include "../KalmanFilter.h"
+#include "../SampleBuffer.h"
 
 namespace Sensors
 {
     class ZeroingState : public CalibrationState
     {
     private:
-        int samples = 0;
-        double sum = 0;
+        BlockAverager<CALIB_BLOCK_SAMPLES> averager{reduceHampel};
 
     public:
         void onEnter() override
         {
-            samples = 0;
-            sum = 0;
+            averager.reset();
         }
-        void update(unsigned long now) override
+        uint32_t samplePeriodUs() override { return CALIB_SAMPLE_PERIOD_US; }
+        void update(unsigned long now) override {}
+        void onSample(const BaroSample &sample) override
         {
-            sum += readPressure();
-            samples++;
-            if (samples >= 500)
+            averager.add(sample.pressure);
+            if (averager.samples() >= 500)
             {
-                calData.adaptiveBaseline = sum / 500.0;
-                kAlt.x = 0;
+                calData.adaptiveBaseline = averager.average();
+                calData.adaptiveFraction = 0;
+                resetAltitudeFilter();
                 stability.reset();
                 sys.calibrated = true;
                 Serial.print("[Sensors] Ноль установлен: ");
-                Serial.println(calData.adaptiveBaseline, 2);
+                Serial.println(toPascals(calData.adaptiveBaseline), 2);
                 transitionToIdle();
             }
         }
-        int getProgress() override { return constrain((samples * 100) / 500, 0, 99); }
+        int getProgress() override { return constrain((int)(averager.samples() * 100) / 500, 0, 99); }
         String getPhaseName() override { return "zeroing"; }
         void serialize(JsonObject &doc) override
         {
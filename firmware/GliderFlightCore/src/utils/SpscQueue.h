@@ -0,0 +1,62 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <Arduino.h>
+
+namespace Utils
+{
+    /**
+     * Очередь без блокировок для одного производителя и одного потребителя.
+     * Производитель (таймер/прерывание) пишет только _head, потребитель (loop)
+     * только _tail, поэтому на одноядерном ESP8266 достаточно volatile-индексов.
+     * N должно быть степенью двойки; полезная емкость N - 1.
+     * push() лежит в IRAM: его можно звать из обработчика прерывания GPIO.
+     */
+    template <typename T, size_t N>
+    class SpscQueue
+    {
+        static_assert((N & (N - 1)) == 0, "SpscQueue size must be a power of two");
+
+    private:
+        T _items[N];
+        volatile size_t _head = 0;
+        volatile size_t _tail = 0;
+        volatile uint32_t _overflows = 0;
+
+    public:
+        bool IRAM_ATTR push(const T &item)
+        {
+            size_t head = _head;
+            size_t next = (head + 1) & (N - 1);
+            if (next == _tail)
+            {
+                _overflows++;
+                return false;
+            }
+            _items[head] = item;
+            __asm__ __volatile__("" ::: "memory"); // данные записаны до публикации индекса
+            _head = next;
+            return true;
+        }
+
+        bool pop(T &out)
+        {
+            size_t tail = _tail;
+            if (tail == _head)
+                return false;
+            out = _items[tail];
+            __asm__ __volatile__("" ::: "memory");
+            _tail = (tail + 1) & (N - 1);
+            return true;
+        }
+
+        size_t size() const { return (_head - _tail) & (N - 1); }
+        bool empty() const { return _head == _tail; }
+        uint32_t overflows() const { return _overflows; }
+
+        // Только со стороны потребителя при остановленном производителе
+        void clear() { _tail = _head; }
+    };
+}
+
+#endif
@@ -0,0 +1,197 @@
+/**
+ * Модель задержки пуска на ПК: тот же путь, что меряет прошивка с
+ * LAUNCH_LATENCY (/system/launch) — фронт отпускания магнита, решение
+ * processRelease(), вход в FLIGHT, отключение Wi-Fi, первое действие.
+ *
+ * Моделируется кооперативный планировщик loop() (core/Scheduler.h): за проход
+ * выполняется самая приоритетная задача со сроком, без вытеснения. Периоды
+ * задач — из config/SchedulerTiming.h прошивки, длительности — случайные с типичными значениями
+ * из /system/perf. Генератор с фиксированным зерном: результат повторяем,
+ * поэтому порог -l ловит регрессии (код возврата 1).
+ *
+ * Сборка (из корня репозитория):
+ *   g++ -std=c++11 -O2 -I firmware/GliderFlightCore/src/config \
+ *       tools/launchsim/launchsim.cpp -o launchsim
+ *
+ * Использование:
+ *   launchsim                      10000 пусков, прерывание датчика Холла
+ *   launchsim -n 50000 -w 3000     число пусков, время отключения Wi-Fi, мкс
+ *   launchsim -H 40000             самый долгий HTTP-запрос, мкс
+ *   launchsim -l 10000             код 1, если p99 первого действия выше, мкс
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include "SchedulerTiming.h"
+
+static const uint32_t PASS_OVERHEAD_US = 5; // yield() между проходами loop()
+static const uint32_t SERVO_START_US = 10;  // ServoExecutor::start(): расчет плана и взвод timer1
+
+enum Stage
+{
+    DECISION,
+    TRANSITION,
+    WIFI_OFF,
+    FIRST_ACTION,
+    STAGES
+};
+static const char *const STAGE_NAMES[STAGES] = {"decision", "transition", "wifi_off", "first_action"};
+
+struct Options
+{
+    unsigned launches = 10000;
+    uint32_t wifiOffUs = 1500;  // WiFi.mode(WIFI_OFF) + forceSleepBegin + delay(1)
+    uint32_t httpMaxUs = 40000; // Выгрузка куска лога медленному клиенту
+    uint32_t limitUs = 0;
+};
+
+struct Task
+{
+    uint32_t periodUs;
+    uint64_t lastUs;
+    bool enabled;
+};
+
+class Model
+{
+private:
+    std::mt19937 _rng{12345};
+    const Options &_opt;
+
+    uint32_t uniform(uint32_t lo, uint32_t hi) { return std::uniform_int_distribution<uint32_t>(lo, hi)(_rng); }
+
+    uint32_t sensorsCost() { return uniform(150, 600); }
+    uint32_t flightCost() { return uniform(40, 120); }
+    uint32_t hallCost() { return uniform(5, 15); }
+    // Чаще всего сервер пуст; изредка обрабатывается запрос
+    uint32_t networkCost() { return uniform(0, 99) < 3 ? uniform(2000, _opt.httpMaxUs) : uniform(20, 80); }
+
+public:
+    Model(const Options &opt) : _opt(opt) {}
+
+    /**
+     * Один пуск: задержки этапов от фронта, мкс
+     */
+    void launch(uint32_t out[STAGES])
+    {
+        // Задачи со случайной фазой относительно фронта; приоритет — порядок в массиве
+        Task tasks[3] = {{TASK_SENSORS_PERIOD_US, 0, true}, {TASK_FLIGHT_PERIOD_US, 0, true}, {TASK_NETWORK_PERIOD_US, 0, true}};
+        for (Task &t : tasks)
+            t.lastUs = uniform(0, t.periodUs);
+        uint64_t edge = 100000 + uniform(0, 20000);
+        uint64_t now = 0;
+
+        while (true)
+        {
+            Task *due = nullptr;
+            int index = 0;
+            for (int i = 0; i < 3; i++)
+                if (tasks[i].enabled && now - tasks[i].lastUs >= tasks[i].periodUs)
+                {
+                    due = &tasks[i];
+                    index = i;
+                    break;
+                }
+            if (!due)
+            {
+                now += PASS_OVERHEAD_US;
+                continue;
+            }
+            due->lastUs = now;
+            if (index == 0)
+                now += sensorsCost();
+            else if (index == 2)
+                now += networkCost();
+            else
+            {
+                now += hallCost();
+                // Фронт уже в очереди прерывания: его разберет первый проход задачи полета после него
+                if (now >= edge)
+                {
+                    out[DECISION] = (uint32_t)(now - edge);
+                    out[TRANSITION] = out[DECISION] + 2;
+                    now += 2 + _opt.wifiOffUs;
+                    out[WIFI_OFF] = (uint32_t)(now - edge);
+                    // InFlightMode::onEnter сразу за stopWiFi() запускает программу сервопривода
+                    now += SERVO_START_US;
+                    out[FIRST_ACTION] = (uint32_t)(now - edge);
+                    return;
+                }
+                now += flightCost();
+            }
+            now += PASS_OVERHEAD_US;
+        }
+    }
+};
+
+static uint32_t percentile(std::vector<uint32_t> &v, double p)
+{
+    size_t k = (size_t)(p / 100.0 * (v.size() - 1) + 0.5);
+    std::nth_element(v.begin(), v.begin() + k, v.end());
+    return v[k];
+}
+
+int main(int argc, char **argv)
+{
+    Options opt;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+            opt.launches = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc)
+            opt.wifiOffUs = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-H") == 0 && i + 1 < argc)
+            opt.httpMaxUs = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-l") == 0 && i + 1 < argc)
+            opt.limitUs = atoi(argv[++i]);
+        else
+        {
+            fprintf(stderr, "usage: launchsim [-n N] [-w WIFI_US] [-H HTTP_US] [-l LIMIT_US]\n");
+            return 2;
+        }
+    }
+    if (opt.launches == 0)
+    {
+        fprintf(stderr, "launchsim: -n must be at least 1\n");
+        return 2;
+    }
+
+    Model model(opt);
+    std::vector<uint32_t> samples[STAGES];
+    for (unsigned i = 0; i < opt.launches; i++)
+    {
+        uint32_t out[STAGES];
+        model.launch(out);
+        for (int s = 0; s < STAGES; s++)
+            samples[s].push_back(out[s]);
+    }
+
+    printf("%u launches, wifi off %u us, http up to %u us\n", opt.launches, opt.wifiOffUs, opt.httpMaxUs);
+    printf("%-14s %8s %8s %8s %8s %8s\n", "stage", "min", "avg", "p50", "p99", "max");
+    uint32_t firstActionP99 = 0;
+    for (int s = 0; s < STAGES; s++)
+    {
+        std::vector<uint32_t> &v = samples[s];
+        uint64_t sum = 0;
+        for (uint32_t x : v)
+            sum += x;
+        uint32_t lo = *std::min_element(v.begin(), v.end());
+        uint32_t hi = *std::max_element(v.begin(), v.end());
+        uint32_t p50 = percentile(v, 50);
+        uint32_t p99 = percentile(v, 99);
+        if (s == FIRST_ACTION)
+            firstActionP99 = p99;
+        printf("%-14s %8u %8u %8u %8u %8u\n", STAGE_NAMES[s], lo, (uint32_t)(sum / v.size()), p50, p99, hi);
+    }
+
+    if (opt.limitUs && firstActionP99 > opt.limitUs)
+    {
+        fprintf(stderr, "first_action p99 %u us exceeds limit %u us\n", firstActionP99, opt.limitUs);
+        return 1;
+    }
+    return 0;
+}
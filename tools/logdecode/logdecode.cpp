@@ -0,0 +1,197 @@
+/**
+ * Декодер бортовых логов log_N.dat в CSV.
+ *
+ * Сборка (из корня репозитория):
+ *   g++ -std=c++11 -O2 -I firmware/GliderFlightCore/src/logging \
+ *       tools/logdecode/logdecode.cpp -o logdecode
+ *
+ * Использование:
+ *   logdecode log_3.dat > log_3.csv
+ *   logdecode -r 10 log_3.dat       равномерная шкала 10 Гц (линейная интерполяция)
+ *   logdecode -s log_3.dat          только заголовок и статистика
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "LogFormat.h"
+#include "LogCodec.h"
+#include "LogBlock.h"
+
+using namespace Logging;
+
+static bool readFile(const char *path, std::vector<uint8_t> &data)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f)
+        return false;
+    uint8_t buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0)
+        data.insert(data.end(), buf, buf + n);
+    fclose(f);
+    return true;
+}
+
+/**
+ * Разбор страниц с записями; возвращает номер первого битого блока
+ * (журнал v4, хвост после сброса питания) или 0, если все целые.
+ * firstPage — номер первого блока данных: во фрагменте /logs/<n>?from=&to=
+ * за заголовком идут страницы с k-й, а не с первой.
+ */
+static size_t decodePages(const std::vector<uint8_t> &data, const LogHeader &header, uint16_t encoding,
+                          std::vector<LogRecord> &out, uint16_t &firstPage)
+{
+    firstPage = 1;
+    uint16_t seq = 1;
+    for (size_t offset = LOG_PAGE_SIZE; offset < data.size(); offset += LOG_PAGE_SIZE)
+    {
+        size_t len = data.size() - offset < LOG_PAGE_SIZE ? data.size() - offset : LOG_PAGE_SIZE;
+        const uint8_t *page = data.data() + offset;
+        LogRecord rec;
+
+        // Таблица поиска в хвосте лога — записи кончились
+        uint32_t magic = 0;
+        if (len >= sizeof(magic))
+            memcpy(&magic, page, sizeof(magic));
+        if (magic == LOG_SEEK_MAGIC)
+            break;
+        if (header.version >= 4)
+        {
+            // Номер первого блока задает начало отсчета, дальше блоки идут подряд
+            uint16_t actual;
+            if (offset == LOG_PAGE_SIZE && blockIntact(page, len, actual) && actual > 0)
+                firstPage = seq = actual;
+            if (!blockValid(page, len, seq++))
+                return offset / LOG_PAGE_SIZE;
+        }
+
+        if (encoding == LOG_ENCODING_DELTA)
+        {
+            PageDecoder decoder(page, pagePayload(header.version, len));
+            while (decoder.next(rec))
+                out.push_back(rec);
+        }
+        else
+        {
+            for (size_t pos = 0; pos + sizeof(LogRecord) <= len; pos += sizeof(LogRecord))
+            {
+                memcpy(&rec, page + pos, sizeof(rec));
+                out.push_back(rec);
+            }
+        }
+    }
+    return 0;
+}
+
+static void printRow(double timeMs, double pressure, double altitudeCm, double temperatureCenti, uint8_t flags, unsigned rateHz)
+{
+    printf("%.0f,%.1f,%.2f,%.2f,%d,%d,%u\n", timeMs, pressure, altitudeCm / 100.0, temperatureCenti / 100.0,
+           flags & REC_CALIBRATED ? 1 : 0, flags & REC_STABLE ? 1 : 0, rateHz);
+}
+
+/**
+ * Перевод на равномерную шкалу: записи идут с разной частотой (расписание,
+ * предзапись), значения между ними интерполируются, флаги берутся от
+ * предыдущей записи.
+ */
+static void printUniform(const std::vector<LogRecord> &records, unsigned hz)
+{
+    double step = 1000.0 / hz;
+    size_t i = 0;
+    for (double t = records.front().timeMs; t <= records.back().timeMs; t += step)
+    {
+        while (i + 1 < records.size() && records[i + 1].timeMs <= t)
+            i++;
+        const LogRecord &a = records[i];
+        const LogRecord &b = i + 1 < records.size() ? records[i + 1] : a;
+        double k = b.timeMs > a.timeMs ? (t - a.timeMs) / (b.timeMs - a.timeMs) : 0;
+        printRow(t, a.pressurePa + k * (b.pressurePa - a.pressurePa),
+                 a.altitudeCm + k * (b.altitudeCm - a.altitudeCm),
+                 a.temperatureCenti + k * (b.temperatureCenti - a.temperatureCenti), a.flags, hz);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    bool summaryOnly = false;
+    unsigned uniformHz = 0;
+    const char *path = nullptr;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-s") == 0)
+            summaryOnly = true;
+        else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+            uniformHz = atoi(argv[++i]);
+        else
+            path = argv[i];
+    }
+    if (!path)
+    {
+        fprintf(stderr, "usage: logdecode [-s] [-r HZ] log_N.dat\n");
+        return 2;
+    }
+
+    std::vector<uint8_t> data;
+    if (!readFile(path, data))
+    {
+        fprintf(stderr, "cannot read %s\n", path);
+        return 1;
+    }
+    if (data.size() < LOG_PAGE_SIZE)
+    {
+        fprintf(stderr, "%s: file is shorter than the header page\n", path);
+        return 1;
+    }
+
+    LogHeader header;
+    memcpy(&header, data.data(), sizeof(header));
+    if (header.magic != LOG_MAGIC)
+    {
+        fprintf(stderr, "%s: bad magic\n", path);
+        return 1;
+    }
+    // Версия 1 не знала поля encoding (там был резерв = 0 = FIXED)
+    uint16_t encoding = header.version >= 2 ? header.encoding : (uint16_t)LOG_ENCODING_FIXED;
+
+    std::vector<LogRecord> records;
+    uint16_t firstPage;
+    size_t badBlock = decodePages(data, header, encoding, records, firstPage);
+
+    // До версии 3 частота в записях не хранилась
+    unsigned rateChanges = 0;
+    for (size_t i = 0; i < records.size(); i++)
+    {
+        if (records[i].rateHz == 0)
+            records[i].rateHz = header.rateHz;
+        if (i > 0 && records[i].rateHz != records[i - 1].rateHz)
+            rateChanges++;
+    }
+
+    if (!summaryOnly)
+    {
+        printf("time_ms,pressure_pa,altitude_m,temperature_c,calibrated,stable,rate_hz\n");
+        if (uniformHz > 0 && !records.empty())
+            printUniform(records, uniformHz);
+        else
+            for (const LogRecord &rec : records)
+                printRow(rec.timeMs, rec.pressurePa, rec.altitudeCm, rec.temperatureCenti, rec.flags, rec.rateHz);
+    }
+
+    int32_t maxAltCm = INT32_MIN;
+    for (const LogRecord &rec : records)
+        if (rec.altitudeCm > maxAltCm)
+            maxAltCm = rec.altitudeCm;
+
+    fprintf(stderr, "flight %u, v%u, %s, start %u Hz, base %.3f Pa\n", header.flightId, header.version,
+            encoding == LOG_ENCODING_DELTA ? "delta" : "fixed", header.rateHz, header.basePressureMilliPa / 1000.0);
+    if (!records.empty())
+        fprintf(stderr, "%zu records, %.1f .. %.1f s, %u rate changes, max altitude %.2f m, %zu bytes (%.2f bytes/record)\n",
+                records.size(), records.front().timeMs / 1000.0, records.back().timeMs / 1000.0, rateChanges,
+                maxAltCm / 100.0, data.size(), (double)(data.size() - LOG_PAGE_SIZE) / records.size());
+    if (firstPage > 1)
+        fprintf(stderr, "fragment: data pages from %u\n", firstPage);
+    if (badBlock)
+        fprintf(stderr, "damaged block %zu (offset %zu): log is cut there\n", badBlock, badBlock * LOG_PAGE_SIZE);
+    return 0;
+}